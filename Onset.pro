@@ -4,34 +4,15 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
-
-TARGET = Onset
-TEMPLATE = app
-
-
-SOURCES += main.cpp\
-        onset.cpp \
-    qcustomplot.cpp \
-    audio.cpp \
-    audioplot.cpp \
-    transform.cpp \
-    sampleprocessingdialog.cpp
-
-HEADERS  += onset.h \
-    qcustomplot.h \
-    audio.h \
-    audioplot.h \
-    transform.h \
-    sampleprocessingdialog.h
-
-FORMS    += onset.ui \
-    sampleprocessingdialog.ui
-
-LIBS     += -L$$PWD -lbass
-LIBS     += -LS$$PWD -lbass_fx
-
-RESOURCES += \
-    res/resources.qrc
+# core is the analysis without widgets, app the Qt Widgets window and
+# cli the command line tool, both linking it; tests checks core, make check runs it
+TEMPLATE = subdirs
+
+SUBDIRS += core \
+    app \
+    cli \
+    tests
+
+app.depends = core
+cli.depends = core
+tests.depends = core
@@ -0,0 +1,337 @@
+#include "analysisgraph.h"
+#include <algorithm>
+
+AnalysisGraph::AnalysisGraph( QCPAxis *keyAxis, QCPAxis *valueAxis ) :
+    QCPAbstractPlottable( keyAxis, valueAxis ),
+    hasRange( false ),
+    lineStyle( LINE_STYLE_LINE ),
+    baseValue( 0.0 ) {
+
+    mPen.setColor( Qt::blue );
+    mPen.setStyle( Qt::SolidLine );
+    mBrush.setStyle( Qt::NoBrush );
+    mSelectedPen = mPen;
+    mSelectedBrush = mBrush;
+}
+
+void AnalysisGraph::setData( const QVector<SeriesView> &segments ) {
+    this->segments = segments;
+}
+
+void AnalysisGraph::setRange( float firstKey, float lastKey, float minValue, float maxValue ) {
+    keyRange = QCPRange( firstKey, lastKey );
+    valueRange = QCPRange( minValue, maxValue );
+    hasRange = true;
+}
+
+void AnalysisGraph::setLineStyle( LINE_STYLE lineStyle ) {
+    this->lineStyle = lineStyle;
+}
+
+void AnalysisGraph::setScatterStyle( const QCPScatterStyle &scatterStyle ) {
+    this->scatterStyle = scatterStyle;
+}
+
+void AnalysisGraph::setBaseValue( double baseValue ) {
+    this->baseValue = baseValue;
+}
+
+const QVector<SeriesView> &AnalysisGraph::getData() const {
+    return segments;
+}
+
+double AnalysisGraph::getValueAfter( double key ) const {
+    for ( int s = 0 ; s < segments.size() ; s++ ) {
+        const SeriesView &segment = segments.at( s );
+        const float *keysEnd = segment.keys + segment.count;
+        const float *it = std::upper_bound( segment.keys, keysEnd, ( float ) key );
+        if ( it != keysEnd ) {
+            return segment.values[it - segment.keys];
+        }
+    }
+
+    return 0.0;
+}
+
+void AnalysisGraph::clearData() {
+    segments.clear();
+    hasRange = false;
+}
+
+double AnalysisGraph::selectTest( const QPointF &pos, bool onlySelectable, QVariant *details ) const {
+    Q_UNUSED( pos )
+    Q_UNUSED( onlySelectable )
+    Q_UNUSED( details )
+
+    return -1;
+}
+
+void AnalysisGraph::draw( QCPPainter *painter ) {
+    if ( !mKeyAxis || !mValueAxis || segments.isEmpty() || mKeyAxis.data()->range().size() <= 0 ) {
+        return;
+    }
+
+    //consecutive blocks continue each other, so their points join into one line
+    QVector<QPointF> points;
+    double firstKey = 0.0;
+    double lastKey = 0.0;
+    int visibleCount = 0;
+    for ( int s = 0 ; s < segments.size() ; s++ ) {
+        const SeriesView &segment = segments.at( s );
+        int begin, end;
+        this->getVisibleRange( segment, begin, end );
+        if ( begin >= end ) {
+            continue;
+        }
+
+        if ( visibleCount == 0 ) {
+            firstKey = segment.keys[begin];
+        }
+        lastKey = segment.keys[end - 1];
+        visibleCount += end - begin;
+
+        this->appendLinePoints( segment, begin, end, points );
+    }
+
+    if ( visibleCount == 0 ) {
+        return;
+    }
+
+    if ( lineStyle == LINE_STYLE_LINE && mainBrush().style() != Qt::NoBrush && mainBrush().color().alpha() != 0 ) {
+        QPolygonF fill( points );
+        fill.prepend( coordsToPixels( firstKey, baseValue ) );
+        fill.append( coordsToPixels( lastKey, baseValue ) );
+
+        applyFillAntialiasingHint( painter );
+        painter->setPen( Qt::NoPen );
+        painter->setBrush( mainBrush() );
+        painter->drawPolygon( fill );
+    }
+
+    if ( mainPen().style() != Qt::NoPen && mainPen().color().alpha() != 0 ) {
+        applyDefaultAntialiasingHint( painter );
+        painter->setBrush( Qt::NoBrush );
+
+        if ( lineStyle == LINE_STYLE_IMPULSE ) {
+            QPen pen = mainPen();
+            pen.setCapStyle( Qt::FlatCap );
+            painter->setPen( pen );
+
+            double basePixel = mValueAxis.data()->coordToPixel( baseValue );
+            bool horizontal = mKeyAxis.data()->orientation() == Qt::Horizontal;
+            QVector<QLineF> lines;
+            lines.reserve( points.size() );
+            for ( int i = 0 ; i < points.size() ; i++ ) {
+                const QPointF &point = points.at( i );
+                lines.append( horizontal ? QLineF( point.x(), basePixel, point.x(), point.y() ) :
+                              QLineF( basePixel, point.y(), point.x(), point.y() ) );
+            }
+            painter->drawLines( lines );
+        } else {
+            painter->setPen( mainPen() );
+            painter->drawPolyline( points.constData(), points.size() );
+        }
+    }
+
+    double pixelSpan = qAbs( mKeyAxis.data()->coordToPixel( lastKey ) - mKeyAxis.data()->coordToPixel( firstKey ) );
+    if ( !scatterStyle.isNone() && visibleCount <= pixelSpan ) {
+        applyScattersAntialiasingHint( painter );
+        scatterStyle.applyTo( painter, mainPen() );
+        for ( int s = 0 ; s < segments.size() ; s++ ) {
+            const SeriesView &segment = segments.at( s );
+            int begin, end;
+            this->getVisibleRange( segment, begin, end );
+            for ( int i = begin ; i < end ; i++ ) {
+                scatterStyle.drawShape( painter, coordsToPixels( segment.keys[i], segment.values[i] ) );
+            }
+        }
+    }
+}
+
+void AnalysisGraph::drawLegendIcon( QCPPainter *painter, const QRectF &rect ) const {
+    if ( mBrush.style() != Qt::NoBrush ) {
+        applyFillAntialiasingHint( painter );
+        painter->fillRect( QRectF( rect.left(), rect.top() + rect.height() / 2.0, rect.width(), rect.height() / 3.0 ), mBrush );
+    }
+
+    applyDefaultAntialiasingHint( painter );
+    painter->setPen( mPen );
+    painter->drawLine( QLineF( rect.left(), rect.top() + rect.height() / 2.0, rect.right() + 5, rect.top() + rect.height() / 2.0 ) );
+}
+
+QCPRange AnalysisGraph::getKeyRange( bool &foundRange, SignDomain inSignDomain ) const {
+    Q_UNUSED( inSignDomain )
+
+    foundRange = hasRange;
+
+    return keyRange;
+}
+
+QCPRange AnalysisGraph::getValueRange( bool &foundRange, SignDomain inSignDomain ) const {
+    Q_UNUSED( inSignDomain )
+
+    foundRange = hasRange;
+
+    return valueRange;
+}
+
+void AnalysisGraph::getVisibleRange( const SeriesView &segment, int &begin, int &end ) const {
+    QCPRange range = mKeyAxis.data()->range();
+    const float *keysEnd = segment.keys + segment.count;
+
+    begin = std::lower_bound( segment.keys, keysEnd, ( float ) range.lower ) - segment.keys;
+    end = std::upper_bound( segment.keys, keysEnd, ( float ) range.upper ) - segment.keys;
+
+    //keep one point beyond each edge so lines leave the axis rect
+    begin = qMax( 0, begin - 1 );
+    end = qMin( segment.count, end + 1 );
+}
+
+void AnalysisGraph::appendLinePoints( const SeriesView &segment, int begin, int end, QVector<QPointF> &points ) const {
+    const float *keys = segment.keys;
+    const float *values = segment.values;
+    QCPAxis *keyAxis = mKeyAxis.data();
+
+    double pixelSpan = qAbs( keyAxis->coordToPixel( keys[end - 1] ) - keyAxis->coordToPixel( keys[begin] ) );
+    if ( end - begin <= 2 * pixelSpan + 2 ) {
+        for ( int i = begin ; i < end ; i++ ) {
+            points.append( coordsToPixels( keys[i], values[i] ) );
+        }
+        return;
+    }
+
+    //more points than pixels, keep min and max of every pixel column
+    int i = begin;
+    while ( i < end ) {
+        int column = ( int ) keyAxis->coordToPixel( keys[i] );
+        int minIndex = i;
+        int maxIndex = i;
+        int j = i + 1;
+        while ( j < end && ( int ) keyAxis->coordToPixel( keys[j] ) == column ) {
+            if ( values[j] < values[minIndex] ) {
+                minIndex = j;
+            }
+            if ( values[j] > values[maxIndex] ) {
+                maxIndex = j;
+            }
+            j++;
+        }
+
+        if ( lineStyle == LINE_STYLE_IMPULSE ) {
+            points.append( coordsToPixels( keys[maxIndex], values[maxIndex] ) );
+        } else {
+            int first = qMin( minIndex, maxIndex );
+            int second = qMax( minIndex, maxIndex );
+            points.append( coordsToPixels( keys[i], values[i] ) );
+            if ( first != i ) {
+                points.append( coordsToPixels( keys[first], values[first] ) );
+            }
+            if ( second != first ) {
+                points.append( coordsToPixels( keys[second], values[second] ) );
+            }
+            if ( j - 1 != second && j - 1 != i ) {
+                points.append( coordsToPixels( keys[j - 1], values[j - 1] ) );
+            }
+        }
+
+        i = j;
+    }
+}
+
+PeriodGraph::PeriodGraph( QCPAxis *keyAxis, QCPAxis *valueAxis ) :
+    QCPAbstractPlottable( keyAxis, valueAxis ),
+    periods( 0 ),
+    count( 0 ),
+    periodType( 0 ),
+    height( 1.0 ) {
+
+    mPen.setColor( Qt::blue );
+    mPen.setStyle( Qt::SolidLine );
+    mBrush.setStyle( Qt::NoBrush );
+    mSelectedPen = mPen;
+    mSelectedBrush = mBrush;
+}
+
+void PeriodGraph::setData( const float *periods, int count ) {
+    this->periods = periods;
+    this->count = count;
+}
+
+void PeriodGraph::setPeriodType( int periodType, double height ) {
+    this->periodType = periodType;
+    this->height = height;
+}
+
+void PeriodGraph::clearData() {
+    periods = 0;
+    count = 0;
+}
+
+double PeriodGraph::selectTest( const QPointF &pos, bool onlySelectable, QVariant *details ) const {
+    Q_UNUSED( pos )
+    Q_UNUSED( onlySelectable )
+    Q_UNUSED( details )
+
+    return -1;
+}
+
+void PeriodGraph::draw( QCPPainter *painter ) {
+    if ( !mKeyAxis || !mValueAxis || count <= 0 ) {
+        return;
+    }
+
+    QCPRange range = mKeyAxis.data()->range();
+    for ( int i = 0 ; i + 2 < count ; i += 3 ) {
+        double periodBegin = periods[i + 1];
+        double periodEnd = periods[i + 2];
+        if ( ( int ) periods[i] != periodType || periodEnd < range.lower || periodBegin > range.upper ) {
+            continue;
+        }
+
+        QPolygonF polygon;
+        polygon << coordsToPixels( periodBegin - 0.00001, 0.0 ) << coordsToPixels( periodBegin, height )
+                << coordsToPixels( periodEnd, height ) << coordsToPixels( periodEnd + 0.00001, 0.0 );
+
+        applyFillAntialiasingHint( painter );
+        painter->setPen( Qt::NoPen );
+        painter->setBrush( mainBrush() );
+        painter->drawPolygon( polygon );
+
+        applyDefaultAntialiasingHint( painter );
+        painter->setPen( mainPen() );
+        painter->setBrush( Qt::NoBrush );
+        painter->drawPolyline( polygon );
+    }
+}
+
+void PeriodGraph::drawLegendIcon( QCPPainter *painter, const QRectF &rect ) const {
+    applyFillAntialiasingHint( painter );
+    painter->fillRect( QRectF( rect.left(), rect.top() + rect.height() / 2.0, rect.width(), rect.height() / 3.0 ), mBrush );
+}
+
+QCPRange PeriodGraph::getKeyRange( bool &foundRange, SignDomain inSignDomain ) const {
+    Q_UNUSED( inSignDomain )
+
+    QCPRange range;
+    foundRange = false;
+    for ( int i = 0 ; i + 2 < count ; i += 3 ) {
+        if ( ( int ) periods[i] != periodType ) {
+            continue;
+        }
+        if ( !foundRange ) {
+            range = QCPRange( periods[i + 1], periods[i + 2] );
+            foundRange = true;
+        } else {
+            range.expand( QCPRange( periods[i + 1], periods[i + 2] ) );
+        }
+    }
+
+    return range;
+}
+
+//only a graph with periods of its own type has a range, an empty one leaves the shared axis to the others
+QCPRange PeriodGraph::getValueRange( bool &foundRange, SignDomain inSignDomain ) const {
+    this->getKeyRange( foundRange, inSignDomain );
+
+    return QCPRange( 0.0, height );
+}
@@ -0,0 +1,76 @@
+#ifndef ANALYSISGRAPH_H
+#define ANALYSISGRAPH_H
+
+#include "qcustomplot.h"
+#include "analysisfile.h"
+
+//plots the fetched blocks of an AnalysisFile series without copying them,
+//only the points inside the visible key range are touched
+class AnalysisGraph : public QCPAbstractPlottable {
+    Q_OBJECT
+public:
+
+    enum                                LINE_STYLE {
+        LINE_STYLE_LINE,
+        LINE_STYLE_IMPULSE
+    };
+
+    explicit                            AnalysisGraph( QCPAxis *keyAxis, QCPAxis *valueAxis );
+
+    void                                setData( const QVector<SeriesView> &segments );
+    void                                setRange( float firstKey, float lastKey, float minValue, float maxValue );
+    void                                setLineStyle( LINE_STYLE lineStyle );
+    void                                setScatterStyle( const QCPScatterStyle &scatterStyle );
+    void                                setBaseValue( double baseValue );
+
+    const QVector<SeriesView>           &getData() const;
+    double                              getValueAfter( double key ) const;
+
+    virtual void                        clearData();
+    virtual double                      selectTest( const QPointF &pos, bool onlySelectable, QVariant *details = 0 ) const;
+    virtual QCPRange                    getKeyRange( bool &foundRange, SignDomain inSignDomain = sdBoth ) const;
+    virtual QCPRange                    getValueRange( bool &foundRange, SignDomain inSignDomain = sdBoth ) const;
+
+protected:
+    virtual void                        draw( QCPPainter *painter );
+    virtual void                        drawLegendIcon( QCPPainter *painter, const QRectF &rect ) const;
+
+private:
+    QVector<SeriesView>                 segments;
+    bool                                hasRange;
+    QCPRange                            keyRange;
+    QCPRange                            valueRange;
+    LINE_STYLE                          lineStyle;
+    QCPScatterStyle                     scatterStyle;
+    double                              baseValue;
+
+    void                                getVisibleRange( const SeriesView &segment, int &begin, int &end ) const;
+    void                                appendLinePoints( const SeriesView &segment, int begin, int end, QVector<QPointF> &points ) const;
+};
+
+//plots formatted periods of one type as trapezoids
+class PeriodGraph : public QCPAbstractPlottable {
+    Q_OBJECT
+public:
+    explicit                            PeriodGraph( QCPAxis *keyAxis, QCPAxis *valueAxis );
+
+    void                                setData( const float *periods, int count );
+    void                                setPeriodType( int periodType, double height );
+
+    virtual void                        clearData();
+    virtual double                      selectTest( const QPointF &pos, bool onlySelectable, QVariant *details = 0 ) const;
+    virtual QCPRange                    getKeyRange( bool &foundRange, SignDomain inSignDomain = sdBoth ) const;
+    virtual QCPRange                    getValueRange( bool &foundRange, SignDomain inSignDomain = sdBoth ) const;
+
+protected:
+    virtual void                        draw( QCPPainter *painter );
+    virtual void                        drawLegendIcon( QCPPainter *painter, const QRectF &rect ) const;
+
+private:
+    const float                         *periods;
+    int                                 count;
+    int                                 periodType;
+    double                              height;
+};
+
+#endif // ANALYSISGRAPH_H
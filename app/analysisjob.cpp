@@ -0,0 +1,35 @@
+#include "analysisjob.h"
+
+AnalysisJob::AnalysisJob( const AudioAnalysis &analysis, int pcmStep, int window, QAtomicInt *generation ) :
+    analysis( analysis ), pcmStep( pcmStep ), window( window ),
+    generation( generation ), jobGeneration( generation->load() ), reportedPercent( -1 ) {
+
+    this->setAutoDelete( true );
+}
+
+void AnalysisJob::run() {
+    if ( this->isCancelled() ) {
+        emit finished( jobGeneration, false, AnalysisCache() );
+        return;
+    }
+
+    analysis.setObserver( this );
+    bool produced = analysis.produceAudioInfoFile( pcmStep, window );
+    analysis.setObserver( 0 );
+
+    emit finished( jobGeneration, produced, analysis.getCache() );
+}
+
+bool AnalysisJob::isCancelled() {
+    return generation->loadAcquire() != jobGeneration;
+}
+
+//decoding reports every piece, the bar only needs a step per percent
+void AnalysisJob::setProgress( int processed, int total ) {
+    int percent = total > 0 ? ( int ) ( ( qint64 ) processed * 100 / total ) : 0;
+    if ( percent == reportedPercent ) {
+        return;
+    }
+    reportedPercent = percent;
+    emit progressChanged( jobGeneration, processed, total );
+}
@@ -0,0 +1,36 @@
+#ifndef ANALYSISJOB_H
+#define ANALYSISJOB_H
+
+#include <QObject>
+#include <QRunnable>
+#include <QAtomicInt>
+#include "audioanalysis.h"
+
+//produces the audio info file of a copy of an analysis on a pool thread;
+//the job stops once *generation moves past the value it was started with,
+//signals carry that value so receivers can drop results of superseded jobs
+class AnalysisJob : public QObject, public QRunnable, public AudioAnalysis::Observer {
+    Q_OBJECT
+
+public:
+                                        AnalysisJob( const AudioAnalysis &analysis, int pcmStep, int window, QAtomicInt *generation );
+
+    void                                run();
+
+    bool                                isCancelled();
+    void                                setProgress( int processed, int total );
+
+signals:
+    void                                progressChanged( int jobGeneration, int processed, int total );
+    void                                finished( int jobGeneration, bool produced, const AnalysisCache &cache );
+
+private:
+    AudioAnalysis                       analysis;
+    int                                 pcmStep;
+    int                                 window;
+    QAtomicInt                          *generation;
+    int                                 jobGeneration;
+    int                                 reportedPercent;
+};
+
+#endif // ANALYSISJOB_H
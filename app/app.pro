@@ -0,0 +1,42 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2015-02-25T19:37:04
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
+
+TARGET = Onset
+TEMPLATE = app
+
+CONFIG += c++17
+
+include(../core/core.pri)
+
+
+SOURCES += main.cpp\
+        onset.cpp \
+    qcustomplot.cpp \
+    audio.cpp \
+    audioplot.cpp \
+    sampleprocessingdialog.cpp \
+    analysisgraph.cpp \
+    analysisjob.cpp
+
+HEADERS  += onset.h \
+    qcustomplot.h \
+    audio.h \
+    audioplot.h \
+    sampleprocessingdialog.h \
+    analysisgraph.h \
+    analysisjob.h
+
+FORMS    += onset.ui \
+    sampleprocessingdialog.ui
+
+LIBS     += -L$$PWD/.. -lbass_fx
+
+RESOURCES += \
+    ../res/resources.qrc
@@ -0,0 +1,488 @@
+#include "audio.h"
+#include "analysisjob.h"
+
+Audio::Audio( QObject *parent ) :
+    QObject( parent ), stream( 0 ), analysisGeneration( 0 ), liveTap( 0 ),
+    liveThresholdWindowSize( 20 ), liveMultiplier( 1.5f ), liveWindow( true ),
+    livePeakPreWindow( 0 ), livePeakPostWindow( 1 ), livePeakMinInterval( 0 ),
+    liveDetectionFunction( AudioAnalysis::DETECTION_FUNCTION_FLUX ) {
+
+    if ( !BASS_Init( -1, 44100, 0, NULL, NULL ) ) {
+        this->checkError();
+    }
+
+    //one job at a time, a superseded one finishes its current piece before the next starts
+    qRegisterMetaType<AnalysisCache>( "AnalysisCache" );
+    analysisPool.setMaxThreadCount( 1 );
+}
+
+Audio::~Audio() {
+    this->stopLiveTap();
+    this->cancelAudioInfoFile();
+    analysisPool.waitForDone();
+}
+
+bool Audio::loadAudio( const QString &audioFilePath ) {
+    if ( stream ) {
+        this->stopAudio();
+        this->stopLiveTap();
+        if ( !BASS_StreamFree( stream ) ) {
+            this->checkError();
+            return false;
+        }
+        stream = 0;
+    }
+
+    stream = BASS_StreamCreateFile( false, audioFilePath.toStdString().c_str(), 0, 0, BASS_SAMPLE_FLOAT );
+
+    if ( !stream ) {
+        this->checkError();
+        return false;
+    }
+
+    BASS_ChannelGetInfo( stream, &channelInfo );
+    this->audioFilePath = audioFilePath;
+
+    this->startLiveTap();
+
+    QFile file( audioFilePath );
+    file.open( QIODevice::ReadOnly );
+    audioHash = QCryptographicHash::hash( file.readAll(), QCryptographicHash::Sha1 ).toHex();
+    file.close();
+
+    this->cancelAudioInfoFile();
+    analysis.setAudio( audioFilePath, audioHash, channelInfo.freq, channelInfo.chans, this->getAudioDuration() );
+
+    return true;
+}
+
+bool Audio::playAudio() {
+    if ( !stream ) {
+        return false;
+    }
+
+    if ( !BASS_ChannelPlay( stream, false ) ) {
+        this->checkError();
+        return false;
+    }
+
+    return true;
+}
+
+void Audio::stopAudio() {
+    if ( !stream ) {
+        return;
+    }
+
+    BASS_ChannelStop( stream );
+
+    this->seekAudio( 0 );
+}
+
+void Audio::pauseAudio() {
+    if ( !stream ) {
+        return;
+    }
+
+    if ( !BASS_ChannelPause( stream ) ) {
+        this->checkError();
+        return;
+    }
+}
+
+void Audio::seekAudio( double positionSeconds ) {
+    if ( !stream ) {
+        return;
+    }
+
+
+    QWORD audioPos = BASS_ChannelSeconds2Bytes( stream, positionSeconds );
+    if ( !BASS_ChannelSetPosition( stream, audioPos, BASS_POS_BYTE ) ) {
+        this->checkError();
+        return;
+    }
+
+    if ( liveTap ) {
+        liveTap->restart( positionSeconds );
+    }
+}
+
+double Audio::getAudioCurrentPositionSeconds() {
+    if ( !stream ) {
+        return -1.0;
+    }
+
+    QWORD audioPos;
+    double seconds;
+
+    audioPos = BASS_ChannelGetPosition( stream, BASS_POS_BYTE );
+
+    if ( this->checkError() != 0 ) {
+        return -1.0;
+    }
+
+
+    seconds = BASS_ChannelBytes2Seconds( stream, audioPos );
+
+
+    if ( seconds < 0.0 ) {
+        this->checkError();
+    }
+
+    return seconds;
+}
+
+double Audio::getAudioDuration() {
+    if ( !stream ) {
+        return -1.0;
+    }
+
+    QWORD audioLength = BASS_ChannelGetLength( stream, BASS_POS_BYTE );
+
+    if ( this->checkError() != 0 ) {
+        return -1.0;
+    }
+
+    double duration = BASS_ChannelBytes2Seconds( stream, audioLength );
+
+    if ( duration < 0.0 ) {
+        this->checkError();
+    }
+
+    return duration;
+}
+
+int Audio::getAudioFrequency() {
+    if ( !stream ) {
+        return -1;
+    }
+
+    return channelInfo.freq;
+}
+
+int Audio::getAudioChannels() {
+    if ( !stream ) {
+        return -1;
+    }
+
+    return channelInfo.chans;
+}
+
+QString Audio::getAudioInfoFilePath() {
+    return analysis.getAudioInfoFilePath();
+}
+
+QString Audio::getLegacyAudioInfoFilePath() {
+    return analysis.getLegacyAudioInfoFilePath();
+}
+
+QVector<float> Audio::getFlux() {
+    return analysis.getFlux();
+}
+
+QVector<float> Audio::getFeature( FeatureExtractor::FEATURE feature ) {
+    return analysis.getFeature( feature );
+}
+
+QVector<float> Audio::getPeaks() {
+    return analysis.getPeaks();
+}
+
+QVector<float> Audio::getPCM( int pcmStep ) {
+    if ( !stream ) {
+        return QVector<float>();
+    }
+
+    return analysis.getPCM( pcmStep );
+}
+
+void Audio::setOnsetOptions( int onsetThresholdWindowSize, float onsetMultipler, bool window ) {
+    analysis.setOnsetOptions( onsetThresholdWindowSize, onsetMultipler, window );
+
+    if ( onsetThresholdWindowSize == liveThresholdWindowSize && onsetMultipler == liveMultiplier && window == liveWindow ) {
+        return;
+    }
+    liveThresholdWindowSize = onsetThresholdWindowSize;
+    liveMultiplier = onsetMultipler;
+    liveWindow = window;
+    if ( liveTap ) {
+        this->startLiveTap();
+    }
+}
+
+void Audio::setPeakOptions( int preWindow, int postWindow, int minInterval ) {
+    analysis.setPeakOptions( preWindow, postWindow, minInterval );
+
+    if ( preWindow == livePeakPreWindow && postWindow == livePeakPostWindow && minInterval == livePeakMinInterval ) {
+        return;
+    }
+    livePeakPreWindow = preWindow;
+    livePeakPostWindow = postWindow;
+    livePeakMinInterval = minInterval;
+    if ( liveTap ) {
+        this->startLiveTap();
+    }
+}
+
+void Audio::setDetectionFunction( AudioAnalysis::DETECTION_FUNCTION detectionFunction ) {
+    analysis.setDetectionFunction( detectionFunction );
+
+    if ( detectionFunction == liveDetectionFunction ) {
+        return;
+    }
+    liveDetectionFunction = detectionFunction;
+    if ( liveTap ) {
+        this->startLiveTap();
+    }
+}
+
+void Audio::setMultiResolution( bool multiResolution ) {
+    analysis.setMultiResolution( multiResolution );
+}
+
+//blocks until the file is written, startAudioInfoFile() does the same on the analysis thread
+bool Audio::produceAudioInfoFile( int pcmStep, int window ) {
+    if ( !stream ) {
+        return false;
+    }
+
+    this->cancelAudioInfoFile();
+    return analysis.produceAudioInfoFile( pcmStep, window );
+}
+
+//cancels the job in flight and analyses a copy of the current options and cache,
+//audioInfoFileProduced() follows once it's done unless another job replaces it
+void Audio::startAudioInfoFile( int pcmStep, int window ) {
+    if ( !stream ) {
+        emit audioInfoFileProduced( false );
+        return;
+    }
+
+    this->cancelAudioInfoFile();
+
+    AnalysisJob *job = new AnalysisJob( analysis, pcmStep, window, &analysisGeneration );
+    connect( job, SIGNAL( progressChanged( int, int, int ) ),
+             this, SLOT( updateAudioInfoProgress( int, int, int ) ), Qt::QueuedConnection );
+    connect( job, SIGNAL( finished( int, bool, AnalysisCache ) ),
+             this, SLOT( finishAudioInfoFile( int, bool, AnalysisCache ) ), Qt::QueuedConnection );
+    analysisPool.start( job );
+}
+
+void Audio::cancelAudioInfoFile() {
+    analysisGeneration.fetchAndAddOrdered( 1 );
+}
+
+void Audio::updateAudioInfoProgress( int jobGeneration, int processed, int total ) {
+    if ( jobGeneration != analysisGeneration.load() ) {
+        return;
+    }
+
+    emit audioInfoProgressChanged( processed, total );
+}
+
+//the job's cache has what it decoded, later jobs start from it
+void Audio::finishAudioInfoFile( int jobGeneration, bool produced, const AnalysisCache &cache ) {
+    if ( jobGeneration != analysisGeneration.load() ) {
+        return;
+    }
+
+    analysis.setCache( cache );
+    emit audioInfoFileProduced( produced );
+}
+
+//the detector belongs to the tap's thread once it runs, so new options take a new tap;
+//it goes on from the stream's decoding position, where the DSP's next samples are
+void Audio::startLiveTap() {
+    this->stopLiveTap();
+    if ( !stream ) {
+        return;
+    }
+
+    liveTap = new LiveTap( channelInfo.freq, channelInfo.chans, 2, liveWindow );
+    liveTap->getDetector().setOnsetOptions( liveThresholdWindowSize, liveMultiplier );
+    liveTap->getDetector().setPeakOptions( livePeakPreWindow, livePeakPostWindow, livePeakMinInterval );
+    liveTap->getDetector().setDetectionFunction( liveDetectionFunction );
+    liveTap->setListener( this );
+
+    QWORD decodePosition = BASS_ChannelGetPosition( stream, BASS_POS_BYTE | BASS_POS_DECODE );
+    if ( decodePosition != ( QWORD ) -1 ) {
+        liveTap->restart( BASS_ChannelBytes2Seconds( stream, decodePosition ) );
+    }
+    if ( liveTap->attach( stream ) ) {
+        liveTap->start();
+    }
+}
+
+//waits for the tap's thread, no live signals are emitted after this
+void Audio::stopLiveTap() {
+    if ( !liveTap ) {
+        return;
+    }
+
+    delete liveTap;
+    liveTap = 0;
+}
+
+//called on the tap's thread, the signals are queued to the receivers
+void Audio::onsetDetected( double time, float strength ) {
+    emit liveOnsetDetected( time, strength );
+}
+
+void Audio::levelMeasured( double time, float rms ) {
+    emit liveLevelMeasured( time, rms );
+}
+
+int Audio::checkError() {
+    int errorCode = BASS_ErrorGetCode();
+
+    switch ( errorCode ) {
+        case 0:
+            break;
+
+        case 1:
+            qDebug() << "BASS_ERROR_MEM";
+            break;
+
+        case 2:
+            qDebug() << "BASS_ERROR_FILEOPEN";
+            break;
+
+        case 3:
+            qDebug() << "BASS_ERROR_DRIVER";
+            break;
+
+        case 4:
+            qDebug() << "BASS_ERROR_BUFLOST";
+            break;
+
+        case 5:
+            qDebug() << "BASS_ERROR_HANDLE";
+            break;
+
+        case 6:
+            qDebug() << "BASS_ERROR_FORMAT";
+            break;
+
+        case 7:
+            qDebug() << "BASS_ERROR_POSITION";
+            break;
+
+        case 8:
+            qDebug() << "BASS_ERROR_INIT";
+            break;
+
+        case 9:
+            qDebug() << "BASS_ERROR_START";
+            break;
+
+        case 14:
+            qDebug() << "BASS_ERROR_ALREADY";
+            break;
+
+        case 18:
+            qDebug() << "BASS_ERROR_NOCHAN";
+            break;
+
+        case 19:
+            qDebug() << "BASS_ERROR_ILLTYPE";
+            break;
+
+        case 20:
+            qDebug() << "BASS_ERROR_ILLPARAM";
+            break;
+
+        case 21:
+            qDebug() << "BASS_ERROR_NO3D";
+            break;
+
+        case 22:
+            qDebug() << "BASS_ERROR_NOEAX";
+            break;
+
+        case 23:
+            qDebug() << "BASS_ERROR_DEVICE";
+            break;
+
+        case 24:
+            qDebug() << "BASS_ERROR_NOPLAY";
+            break;
+
+        case 25:
+            qDebug() << "BASS_ERROR_FREQ";
+            break;
+
+        case 27:
+            qDebug() << "BASS_ERROR_NOTFILE";
+            break;
+
+        case 29:
+            qDebug() << "BASS_ERROR_NOHW";
+            break;
+
+        case 31:
+            qDebug() << "BASS_ERROR_EMPTY";
+            break;
+
+        case 32:
+            qDebug() << "BASS_ERROR_NONET";
+            break;
+
+        case 33:
+            qDebug() << "BASS_ERROR_CREATE";
+            break;
+
+        case 34:
+            qDebug() << "BASS_ERROR_NOFX";
+            break;
+
+        case 37:
+            qDebug() << "BASS_ERROR_NOTAVAIL";
+            break;
+
+        case 38:
+            qDebug() << "BASS_ERROR_DECODE";
+            break;
+
+        case 39:
+            qDebug() << "BASS_ERROR_DX";
+            break;
+
+        case 40:
+            qDebug() << "BASS_ERROR_TIMEOUT";
+            break;
+
+        case 41:
+            qDebug() << "BASS_ERROR_FILEFORM";
+            break;
+
+        case 42:
+            qDebug() << "BASS_ERROR_SPEAKER";
+            break;
+
+        case 43:
+            qDebug() << "BASS_ERROR_VERSION";
+            break;
+
+        case 44:
+            qDebug() << "BASS_ERROR_CODEC";
+            break;
+
+        case 45:
+            qDebug() << "BASS_ERROR_ENDED";
+            break;
+
+        case 46:
+            qDebug() << "BASS_ERROR_BUSY";
+            break;
+
+        case -1:
+            qDebug() << "BASS_ERROR_UNKNOWN";
+            break;
+
+        default:
+            qDebug() << "BASS_ERROR_UNKNOWN";
+            break;
+    }
+
+    return errorCode;
+}
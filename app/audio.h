@@ -0,0 +1,98 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <QObject>
+#include <QDebug>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QVector>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include "bass.h"
+#include "bass_fx.h"
+#include "qmath.h"
+#include "transform.h"
+#include "audioanalysis.h"
+#include "livetap.h"
+
+//the playing stream is also analysed live, liveOnsetDetected() and liveLevelMeasured() follow it
+class Audio : public QObject, private OnlineOnsetDetector::Listener {
+    Q_OBJECT
+
+public:
+    explicit                            Audio( QObject *parent = 0 );
+                                        ~Audio();
+
+    bool                                loadAudio( const QString &audioFilePath );
+    bool                                playAudio();
+    void                                stopAudio();
+    void                                pauseAudio();
+    void                                seekAudio( double positionSeconds );
+
+    double                              getAudioCurrentPositionSeconds();
+    double                              getAudioDuration();
+    int                                 getAudioFrequency();
+    int                                 getAudioChannels();
+
+    int                                 getSampleCount();
+    int                                 getSampleBlockCount( int sampleBlockSize = 1024 );
+    QString                             getSampleBlockDuration( int index, int blockSize = 1024 );
+
+    QString                             getAudioInfoFilePath();
+    QString                             getLegacyAudioInfoFilePath();
+
+    QVector<float>                      getFlux();
+    QVector<float>                      getFeature( FeatureExtractor::FEATURE feature );
+    QVector<float>                      getPeaks();
+    QVector<float>                      getPCM( int pcmStep = 512 );
+    void                                setOnsetOptions( int onsetThresholdWindowSize, float onsetMultipler, bool window );
+    void                                setPeakOptions( int preWindow, int postWindow, int minInterval );
+    void                                setDetectionFunction( AudioAnalysis::DETECTION_FUNCTION detectionFunction );
+    void                                setMultiResolution( bool multiResolution );
+
+public slots:
+    bool                                produceAudioInfoFile( int pcmStep = 512, int window = 256 );
+    void                                startAudioInfoFile( int pcmStep = 512, int window = 256 );
+    void                                cancelAudioInfoFile();
+
+signals:
+    void                                audioInfoProgressChanged( int processed, int total );
+    void                                audioInfoFileProduced( bool produced );
+    void                                liveOnsetDetected( double time, float strength );
+    void                                liveLevelMeasured( double time, float rms );
+
+private slots:
+    void                                updateAudioInfoProgress( int jobGeneration, int processed, int total );
+    void                                finishAudioInfoFile( int jobGeneration, bool produced, const AnalysisCache &cache );
+
+private:
+    HSTREAM                             stream;
+    BASS_CHANNELINFO                    channelInfo;
+
+    QString                             audioFilePath;
+    QString                             audioHash;
+    AudioAnalysis                       analysis;
+
+    //bumped to cancel the running job; the pool is declared after it, so it's waited for first
+    QAtomicInt                          analysisGeneration;
+    QThreadPool                         analysisPool;
+
+    LiveTap                             *liveTap;
+
+    //options of the live detection, the tap is created again when they change
+    int                                 liveThresholdWindowSize;
+    float                               liveMultiplier;
+    bool                                liveWindow;
+    int                                 livePeakPreWindow;
+    int                                 livePeakPostWindow;
+    int                                 livePeakMinInterval;
+    AudioAnalysis::DETECTION_FUNCTION   liveDetectionFunction;
+
+    void                                startLiveTap();
+    void                                stopLiveTap();
+    void                                onsetDetected( double time, float strength );
+    void                                levelMeasured( double time, float rms );
+    int                                 checkError();
+};
+
+#endif // AUDIO_H
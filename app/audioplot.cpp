@@ -0,0 +1,267 @@
+#include "audioplot.h"
+
+AudioPlot::AudioPlot( QWidget *parent ) :
+    QCustomPlot( parent ),
+    audio( 0 ),
+    viewMode( VIEW_MODE_ONSET ),
+    seconds( 0.0 ),
+    showPosition( true ),
+    showMean( false ),
+    meanAll( 0.0 ) {
+
+    onsetGraph = this->addAnalysisGraph();
+    pcmGraph = this->addAnalysisGraph();
+    pcmFormattedDangerGraph = this->addPeriodGraph( AudioAnalysis::PERIOD_TYPE_DANGER, 1.0 );
+    pcmFormattedSafeGraph = this->addPeriodGraph( AudioAnalysis::PERIOD_TYPE_SAFE, 0.2 );
+    pcmFormattedCautionGraph = this->addPeriodGraph( AudioAnalysis::PERIOD_TYPE_CAUTION, 0.5 );
+    meanGraph = this->addGraph();
+    this->xAxis->setRange( 0, 1 );
+    this->yAxis->setRange( 0, 1 );
+    this->setInteraction( QCP::iRangeDrag, true );
+    this->setInteraction( QCP::iRangeZoom, true );
+    this->axisRect()->setRangeDrag( Qt::Horizontal );
+    this->axisRect()->setRangeZoom( Qt::Horizontal );
+
+    this->setPositionInSeconds( 0.0 );
+
+    onsetGraph->setScatterStyle( QCPScatterStyle::ssDisc );
+    onsetGraph->setLineStyle( AnalysisGraph::LINE_STYLE_IMPULSE );
+
+    pcmGraph->setVisible( false );
+    pcmGraph->setBrush( QBrush( QColor( 0, 0, 255, 90 ) ) );
+
+    pcmFormattedDangerGraph->setVisible( false );
+    pcmFormattedDangerGraph->setBrush( QBrush( QColor( 0, 0, 255, 90 ) ) );
+
+    pcmFormattedSafeGraph->setVisible( false );
+    pcmFormattedSafeGraph->setBrush( QBrush( QColor( 0, 255, 0, 90 ) ) );
+    pcmFormattedSafeGraph->setPen( QPen( Qt::green ) );
+
+    pcmFormattedCautionGraph->setVisible( false );
+    pcmFormattedCautionGraph->setBrush( QBrush( QColor( 255, 150, 0, 90 ) ) );
+    pcmFormattedCautionGraph->setPen( QPen( Qt::red ) );
+
+    meanGraph->setVisible( false );
+    meanGraph->setPen( QPen( Qt::red ) );
+
+    connect( this, SIGNAL( mousePress( QMouseEvent * ) ), this, SLOT( onRightClick( QMouseEvent * ) ) );
+    connect( this, SIGNAL( mouseMove( QMouseEvent * ) ), this, SLOT( getCursorCoordinates( QMouseEvent * ) ) );
+    connect( this->xAxis, SIGNAL( rangeChanged( QCPRange ) ), this, SLOT( fetchVisibleBlocks( QCPRange ) ) );
+}
+
+void AudioPlot::setAudio( Audio *audio ) {
+    this->audio = audio;
+}
+
+bool AudioPlot::loadAudioInfoFile( const QString &audioInfoFilePath ) {
+    this->closeAudioInfoFile();
+
+    if ( !analysisFile.open( audioInfoFilePath ) && !analysisFile.openLegacy( audioInfoFilePath ) ) {
+        this->replot();
+        return false;
+    }
+
+    meanAll = analysisFile.getMeanAll();
+
+    float firstKey, lastKey, minValue, maxValue;
+    if ( analysisFile.getSeriesRange( AnalysisFile::SERIES_ONSET, &firstKey, &lastKey, &minValue, &maxValue ) ) {
+        onsetGraph->setRange( firstKey, lastKey, minValue, maxValue );
+    }
+
+    float stressEnd = 0.0;
+    if ( analysisFile.getSeriesRange( AnalysisFile::SERIES_STRESS, &firstKey, &lastKey, &minValue, &maxValue ) ) {
+        pcmGraph->setRange( firstKey, lastKey, minValue, maxValue );
+        stressEnd = lastKey;
+    }
+    pcmGraph->setBaseValue( meanAll );
+
+    const QVector<float> &periods = analysisFile.getPeriods();
+    pcmFormattedDangerGraph->setData( periods.constData(), periods.size() );
+    pcmFormattedSafeGraph->setData( periods.constData(), periods.size() );
+    pcmFormattedCautionGraph->setData( periods.constData(), periods.size() );
+
+    QVector<double> meanX;
+    QVector<double> meanY;
+    meanX << 0.0 << stressEnd;
+    meanY << meanAll << meanAll;
+    meanGraph->clearData();
+    meanGraph->setData( meanX, meanY );
+
+    this->fetchVisibleBlocks( this->xAxis->range() );
+    this->replot();
+
+    return true;
+}
+
+void AudioPlot::closeAudioInfoFile() {
+    onsetGraph->clearData();
+    pcmGraph->clearData();
+    pcmFormattedDangerGraph->clearData();
+    pcmFormattedSafeGraph->clearData();
+    pcmFormattedCautionGraph->clearData();
+
+    analysisFile.close();
+}
+
+void AudioPlot::setPositionInSeconds( double seconds ) {
+    this->seconds = seconds;
+
+    this->update();
+}
+
+void AudioPlot::setViewMode( VIEW_MODE viewMode ) {
+    this->viewMode = viewMode;
+
+    switch ( viewMode ) {
+        case VIEW_MODE_ONSET:
+            onsetGraph->setVisible( true );
+            pcmGraph->setVisible( false );
+            pcmFormattedDangerGraph->setVisible( false );
+            pcmFormattedSafeGraph->setVisible( false );
+            pcmFormattedCautionGraph->setVisible( false );
+            meanGraph->setVisible( false );
+            break;
+        case VIEW_MODE_STRESS:
+            onsetGraph->setVisible( false );
+            pcmGraph->setVisible( true );
+            pcmFormattedDangerGraph->setVisible( false );
+            pcmFormattedSafeGraph->setVisible( false );
+            pcmFormattedCautionGraph->setVisible( false );
+            meanGraph->setVisible( true );
+            break;
+        case VIEW_MODE_STRESS_FORMATTED:
+            onsetGraph->setVisible( false );
+            pcmGraph->setVisible( false );
+            pcmFormattedDangerGraph->setVisible( true);
+            pcmFormattedSafeGraph->setVisible( true );
+            pcmFormattedCautionGraph->setVisible( true );
+            meanGraph->setVisible( false );
+            break;
+    }
+
+    this->resetRangeY();
+}
+
+double AudioPlot::getCurrentValue( double seconds ) {
+    return onsetGraph->getValueAfter( seconds );
+}
+
+void AudioPlot::resetRangeX( bool replot ) {
+    bool foundRange = false;
+    QCPRange range;
+    switch ( viewMode ) {
+        case VIEW_MODE_ONSET:
+            range = onsetGraph->getKeyRange( foundRange );
+            break;
+
+        case VIEW_MODE_STRESS:
+            range = pcmGraph->getKeyRange( foundRange );
+            break;
+
+        case VIEW_MODE_STRESS_FORMATTED:
+            range = pcmFormattedDangerGraph->getKeyRange( foundRange );
+            break;
+    }
+
+    if ( !foundRange ) {
+        return;
+    }
+
+    this->xAxis->setRange( 0, range.upper );
+
+    if ( replot ) {
+        this->replot();
+    }
+}
+
+void AudioPlot::resetRangeY( bool replot ) {
+    bool foundRange = false;
+    QCPRange range;
+    switch ( viewMode ) {
+        case VIEW_MODE_ONSET:
+            range = onsetGraph->getValueRange( foundRange );
+            break;
+
+        case VIEW_MODE_STRESS:
+            range = pcmGraph->getValueRange( foundRange );
+            break;
+
+        case VIEW_MODE_STRESS_FORMATTED:
+            range = pcmFormattedDangerGraph->getValueRange( foundRange );
+            break;
+    }
+
+    if ( !foundRange ) {
+        return;
+    }
+
+    this->yAxis->setRange( range.lower - 0.1, range.upper + 0.1 );
+
+    if ( replot ) {
+        this->replot();
+    }
+}
+
+void AudioPlot::resetRange() {
+    this->resetRangeX( false );
+    this->resetRangeY( false );
+    this->replot();
+}
+
+AnalysisGraph *AudioPlot::addAnalysisGraph() {
+    AnalysisGraph *graph = new AnalysisGraph( this->xAxis, this->yAxis );
+    this->addPlottable( graph );
+
+    return graph;
+}
+
+PeriodGraph *AudioPlot::addPeriodGraph( AudioAnalysis::PERIOD_TYPE periodType, double height ) {
+    PeriodGraph *graph = new PeriodGraph( this->xAxis, this->yAxis );
+    graph->setPeriodType( periodType, height );
+    this->addPlottable( graph );
+
+    return graph;
+}
+
+void AudioPlot::fetchVisibleBlocks( const QCPRange &range ) {
+    if ( !analysisFile.fetchRange( range.lower, range.upper ) ) {
+        return;
+    }
+
+    onsetGraph->setData( analysisFile.getSeries( AnalysisFile::SERIES_ONSET ) );
+    pcmGraph->setData( analysisFile.getSeries( AnalysisFile::SERIES_STRESS ) );
+}
+
+void AudioPlot::paintEvent( QPaintEvent *event ) {
+    QCustomPlot::paintEvent( event );
+
+    QPainter painter( this );
+    QRectF coordsRect( this->width() - 200, 0, 200, 20 );
+    painter.drawText( coordsRect, Qt::AlignRight, cursorCoordinates );
+
+    if ( showPosition ) {
+        painter.setPen( Qt::red );
+        double x = this->xAxis->coordToPixel( seconds );
+        painter.drawLine( x, 0, x, this->height() );
+    }
+}
+
+void AudioPlot::onRightClick( QMouseEvent *mouseEvent ) {
+    if ( mouseEvent->button() != Qt::RightButton ) {
+        return;
+    }
+
+    double positionSeconds = this->xAxis->pixelToCoord( mouseEvent->x() );
+    emit positionChanged( positionSeconds );
+}
+
+void AudioPlot::getCursorCoordinates( QMouseEvent *mouseEvent ) {
+    if ( mouseEvent ) {
+        QString x = QString::number( this->xAxis->pixelToCoord( mouseEvent->x() ), 'f', 2 );
+        QString y = QString::number( this->yAxis->pixelToCoord( mouseEvent->y() ), 'f', 2 );
+        cursorCoordinates = QString( "%1, %2" ).arg( x ).arg( y );
+
+        this->repaint();
+    }
+
+}
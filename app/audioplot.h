@@ -3,6 +3,8 @@
 
 #include "qcustomplot.h"
 #include "audio.h"
+#include "analysisfile.h"
+#include "analysisgraph.h"
 
 class AudioPlot : public QCustomPlot {
     Q_OBJECT
@@ -26,7 +28,8 @@ public:
 
 
 public slots:
-    void                                loadAudioInfoFile( const QString &audioInfoFilePath );
+    bool                                loadAudioInfoFile( const QString &audioInfoFilePath );
+    void                                closeAudioInfoFile();
 
     void                                resetRange();
     void                                resetRangeX( bool replot = true );
@@ -37,25 +40,13 @@ private:
     Audio                               *audio;
     VIEW_MODE                           viewMode;
 
-    QCPGraph                            *onsetGraph;
-    QVector<double>                     xOnset;
-    QVector<double>                     yOnset;
+    AnalysisFile                        analysisFile;
 
-    QCPGraph                            *pcmGraph;
-    QVector<double>                     xPCM;
-    QVector<double>                     yPCM;
-
-    QCPGraph                            *pcmFormattedDangerGraph;
-    QVector<double>                     xFormattedDangerPCM;
-    QVector<double>                     yFormattedDangerPCM;
-
-    QCPGraph                            *pcmFormattedSafeGraph;
-    QVector<double>                     xFormattedSafePCM;
-    QVector<double>                     yFormattedSafePCM;
-
-    QCPGraph                            *pcmFormattedCautionGraph;
-    QVector<double>                     xFormattedCautionPCM;
-    QVector<double>                     yFormattedCautionPCM;
+    AnalysisGraph                       *onsetGraph;
+    AnalysisGraph                       *pcmGraph;
+    PeriodGraph                         *pcmFormattedDangerGraph;
+    PeriodGraph                         *pcmFormattedSafeGraph;
+    PeriodGraph                         *pcmFormattedCautionGraph;
 
     QCPGraph                            *meanGraph;
 
@@ -66,11 +57,15 @@ private:
     bool                                showMean;
     double                              meanAll;
 
+    AnalysisGraph                       *addAnalysisGraph();
+    PeriodGraph                         *addPeriodGraph( AudioAnalysis::PERIOD_TYPE periodType, double height );
+
     void                                paintEvent( QPaintEvent *event );
 
 private slots:
     void                                onRightClick( QMouseEvent *mouseEvent );
     void                                getCursorCoordinates( QMouseEvent *mouseEvent );
+    void                                fetchVisibleBlocks( const QCPRange &range );
 
 signals:
     void                                positionChanged( double positionSeconds );
@@ -0,0 +1,120 @@
+#include "onset.h"
+#include "analysismigration.h"
+#include "analysisbatch.h"
+#include "analysisoptions.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QThread>
+
+//Onset --migrate <directory> [--jobs N] [--io N] [--verbose]
+//converts legacy text audio info files without opening the main window
+static int migrate( int argc, char *argv[] )
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption migrateOption( "migrate", "Convert legacy audio info files of <directory>.", "directory" );
+    QCommandLineOption jobsOption( "jobs", "Number of worker threads.", "count", QString::number( QThread::idealThreadCount() ) );
+    QCommandLineOption ioOption( "io", "Number of files read or written at once.", "count", "4" );
+    QCommandLineOption verboseOption( "verbose", "Print every converted file." );
+    parser.addOption( migrateOption );
+    parser.addOption( jobsOption );
+    parser.addOption( ioOption );
+    parser.addOption( verboseOption );
+    parser.process( a );
+
+    AnalysisMigration migration;
+    migration.setThreadCount( parser.value( jobsOption ).toInt() );
+    migration.setIoConcurrency( parser.value( ioOption ).toInt() );
+    migration.setVerbose( parser.isSet( verboseOption ) );
+
+    bool succeeded = migration.migrate( parser.value( migrateOption ) );
+
+    qInfo() << "converted:" << migration.getConvertedCount()
+            << "skipped:" << migration.getSkippedCount()
+            << "failed:" << migration.getFailedCount();
+
+    return succeeded ? 0 : 1;
+}
+
+//Onset --batch <directory or list>... [--data dir] [--manifest file] [--jobs N] [--decoders N] [--verbose] [analysis options]
+//writes audio info files of whole directories without opening the main window,
+//a file produced with other analysis options is produced again
+static int batch( int argc, char *argv[] )
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument( "paths", "Audio files, directories or list files (.txt, .lst, .m3u) to analyse.", "<paths...>" );
+    QCommandLineOption batchOption( "batch", "Analyse <paths> without a window." );
+    QCommandLineOption dataOption( "data", "Directory of audio info and cache files.", "directory", "D:\\audios" );
+    QCommandLineOption manifestOption( "manifest", "Summary of the run, defaults to batch.tsv in the data directory.", "file" );
+    QCommandLineOption jobsOption( "jobs", "Number of files analysed at once.", "count", QString::number( QThread::idealThreadCount() ) );
+    QCommandLineOption decodersOption( "decoders", "Number of files decoded at once.", "count", QString::number( qMax( 1, QThread::idealThreadCount() / 2 ) ) );
+    QCommandLineOption verboseOption( "verbose", "Print every analysed file." );
+    parser.addOption( batchOption );
+    parser.addOption( dataOption );
+    parser.addOption( manifestOption );
+    parser.addOption( jobsOption );
+    parser.addOption( decodersOption );
+    parser.addOption( verboseOption );
+    AnalysisOptions::addTo( parser );
+    parser.process( a );
+
+    if ( parser.positionalArguments().isEmpty() ) {
+        parser.showHelp( 1 );
+    }
+
+    AnalysisOptions analysisOptions;
+    if ( !analysisOptions.read( parser ) ) {
+        return 1;
+    }
+
+    //decoding channels only, no output device is opened
+    if ( !BASS_Init( 0, 44100, 0, NULL, NULL ) ) {
+        qWarning() << "can't initialize BASS, error" << BASS_ErrorGetCode();
+        return 1;
+    }
+
+    QString dataDirectoryPath = parser.value( dataOption );
+    QString manifestPath = parser.isSet( manifestOption ) ? parser.value( manifestOption ) : QDir( dataDirectoryPath ).filePath( "batch.tsv" );
+
+    AnalysisBatch analysisBatch;
+    analysisBatch.setThreadCount( parser.value( jobsOption ).toInt() );
+    analysisBatch.setDecoderConcurrency( parser.value( decodersOption ).toInt() );
+    analysisBatch.setDataDirectory( dataDirectoryPath );
+    analysisBatch.setManifestPath( manifestPath );
+    analysisBatch.setVerbose( parser.isSet( verboseOption ) );
+    analysisOptions.applyTo( analysisBatch );
+
+    bool succeeded = analysisBatch.analyse( parser.positionalArguments() );
+    BASS_Free();
+
+    //qDebug output is dropped from release builds, the summary isn't
+    qInfo() << "analysed:" << analysisBatch.getAnalysedCount()
+            << "skipped:" << analysisBatch.getSkippedCount()
+            << "failed:" << analysisBatch.getFailedCount();
+
+    return succeeded ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    for ( int i = 1 ; i < argc ; i++ ) {
+        if ( qstrncmp( argv[i], "--migrate", 9 ) == 0 ) {
+            return migrate( argc, argv );
+        }
+        if ( qstrcmp( argv[i], "--batch" ) == 0 ) {
+            return batch( argc, argv );
+        }
+    }
+
+    QApplication a(argc, argv);
+    Onset w;
+    w.show();
+
+    return a.exec();
+}
@@ -4,17 +4,30 @@
 Onset::Onset( QWidget *parent ) :
     QMainWindow( parent ),
     ui( new Ui::Onset ),
-    audioDuration( 0.0 ) {
+    audioDuration( 0.0 ),
+    liveOnsetTime( -1.0 ) {
 
     ui->setupUi( this );
 
     audio = new Audio( this );
     ui->audioPlot->setAudio( audio );
 
+    progressDialog = new SampleProcessingDialog( this );
+    connect( audio, SIGNAL( audioInfoProgressChanged( int, int ) ), this, SLOT( showAudioInfoProgress( int, int ) ) );
+    connect( audio, SIGNAL( audioInfoFileProduced( bool ) ), this, SLOT( showProducedAudioInfo( bool ) ) );
+    connect( audio, SIGNAL( liveOnsetDetected( double, float ) ), this, SLOT( showLiveOnset( double, float ) ) );
+    connect( audio, SIGNAL( liveLevelMeasured( double, float ) ), this, SLOT( showLiveLevel( double, float ) ) );
+
     seekTimer = new QTimer( this );
     seekTimer->setInterval( 30 );
     connect( seekTimer, SIGNAL( timeout() ), this, SLOT( updateSeekInfo() ) );
 
+    //option changes restart it, only the values present once it fires get analysed
+    audioInfoTimer = new QTimer( this );
+    audioInfoTimer->setSingleShot( true );
+    audioInfoTimer->setInterval( 300 );
+    connect( audioInfoTimer, SIGNAL( timeout() ), this, SLOT( updateAudioInfo() ) );
+
     connect( ui->playButton, SIGNAL( clicked() ), this, SLOT( play() ) );
     connect( ui->pauseButton, SIGNAL( clicked() ), this, SLOT( pause() ) );
     connect( ui->stopButton, SIGNAL( clicked() ), this, SLOT( stop() ) );
@@ -32,12 +45,17 @@ Onset::Onset( QWidget *parent ) :
     connect( ui->stressViewModeRadioButton, SIGNAL( toggled( bool ) ), this, SLOT( showStress() ) );
     connect( ui->stressFormattedViewModeRadioButton, SIGNAL( toggled( bool ) ), this, SLOT( showStressFormatted() ) );
 
-    connect( ui->onsetThresholdWindowSizeSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( updateAudioInfo() ) );
-    connect( ui->onsetMultiplierSpinBox, SIGNAL( valueChanged( double ) ), this, SLOT( updateAudioInfo() ) );
-    connect( ui->onsetWindowCheckbox, SIGNAL( toggled( bool ) ), this, SLOT( updateAudioInfo() ) );
+    connect( ui->onsetThresholdWindowSizeSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->onsetMultiplierSpinBox, SIGNAL( valueChanged( double ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->onsetPeakPreWindowSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->onsetPeakPostWindowSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->onsetPeakMinIntervalSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->onsetWindowCheckbox, SIGNAL( toggled( bool ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->onsetSuperFluxCheckbox, SIGNAL( toggled( bool ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->onsetMultiResolutionCheckbox, SIGNAL( toggled( bool ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
 
-    connect( ui->waveformStepSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( updateAudioInfo() ) );
-    connect( ui->stressWindowSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( updateAudioInfo() ) );
+    connect( ui->waveformStepSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
+    connect( ui->stressWindowSpinBox, SIGNAL( valueChanged( int ) ), this, SLOT( scheduleAudioInfoUpdate() ) );
 }
 
 Onset::~Onset() {
@@ -55,6 +73,11 @@ void Onset::loadAudioFile( const QString &audioFilePath ) {
     }
 
     this->stop();
+    audioInfoTimer->stop();
+    progressDialog->hide();
+    liveOnsetTime = -1.0;
+    ui->liveAnalysisLabel->clear();
+    this->applyAnalysisOptions();
     if ( !audio->loadAudio( audioFilePath ) ) {
         return;
     }
@@ -110,19 +133,40 @@ void Onset::updateSeekInfo() {
 }
 
 void Onset::showAudioInfo() {
-    QFile file( audioFilePath );
-    file.open( QIODevice::ReadOnly );
-    QString sha1 = QCryptographicHash::hash( file.readAll(), QCryptographicHash::Sha1 ).toHex();
-    file.close();
-
-    QString audioInfoFilePath = QString( "D:\\audios\\%1.txt" ).arg( sha1 );
-    if ( !QFile::exists( audioInfoFilePath ) ) {
-        int pcmStep = ui->waveformStepSpinBox->value();
-        int window = ui->stressWindowSpinBox->value();
-        audio->produceAudioInfoFile( pcmStep, window );
+    QString audioInfoFilePath = audio->getAudioInfoFilePath();
+    if ( !QFile::exists( audioInfoFilePath ) && QFile::exists( audio->getLegacyAudioInfoFilePath() ) &&
+            ui->audioPlot->loadAudioInfoFile( audio->getLegacyAudioInfoFilePath() ) ) {
+        return;
     }
 
-    ui->audioPlot->loadAudioInfoFile( audioInfoFilePath );
+    //missing, corrupt and older format files, legacy ones included, are produced again
+    if ( !ui->audioPlot->loadAudioInfoFile( audioInfoFilePath ) ) {
+        this->produceAudioInfo();
+    }
+}
+
+//runs on the analysis thread, showProducedAudioInfo() loads the result
+void Onset::produceAudioInfo() {
+    int pcmStep = ui->waveformStepSpinBox->value();
+    int window = ui->stressWindowSpinBox->value();
+    ui->audioPlot->closeAudioInfoFile();
+
+    progressDialog->setSamplesToProcess( 0 );
+    progressDialog->setSamplesProcessed( 0 );
+    progressDialog->show();
+    audio->startAudioInfoFile( pcmStep, window );
+}
+
+void Onset::showAudioInfoProgress( int processed, int total ) {
+    progressDialog->setSamplesToProcess( total );
+    progressDialog->setSamplesProcessed( processed );
+}
+
+void Onset::showProducedAudioInfo( bool produced ) {
+    progressDialog->hide();
+    if ( produced ) {
+        ui->audioPlot->loadAudioInfoFile( audio->getAudioInfoFilePath() );
+    }
 }
 
 void Onset::showOnset() {
@@ -137,16 +181,25 @@ void Onset::showStressFormatted() {
     ui->audioPlot->setViewMode( AudioPlot::VIEW_MODE_STRESS_FORMATTED );
 }
 
+void Onset::scheduleAudioInfoUpdate() {
+    audioInfoTimer->start();
+}
+
 void Onset::updateAudioInfo() {
+    audioInfoTimer->stop();
+    this->applyAnalysisOptions();
+    this->produceAudioInfo();
+}
+
+//the live detection on the playing stream gets them as well
+void Onset::applyAnalysisOptions() {
     int thresholdWindowSize = ui->onsetThresholdWindowSizeSpinBox->value();
     double onsetMultiplier = ui->onsetMultiplierSpinBox->value();
     bool onsetWindow = ui->onsetWindowCheckbox->isChecked();
     audio->setOnsetOptions( thresholdWindowSize, onsetMultiplier, onsetWindow );
-
-    int pcmStep = ui->waveformStepSpinBox->value();
-    int window = ui->stressWindowSpinBox->value();
-    audio->produceAudioInfoFile( pcmStep, window );
-    this->showAudioInfo();
+    audio->setPeakOptions( ui->onsetPeakPreWindowSpinBox->value(), ui->onsetPeakPostWindowSpinBox->value(), ui->onsetPeakMinIntervalSpinBox->value() );
+    audio->setDetectionFunction( ui->onsetSuperFluxCheckbox->isChecked() ? AudioAnalysis::DETECTION_FUNCTION_SUPERFLUX : AudioAnalysis::DETECTION_FUNCTION_FLUX );
+    audio->setMultiResolution( ui->onsetMultiResolutionCheckbox->isChecked() );
 }
 
 void Onset::updateSeekSlider( double audioPosition ) {
@@ -165,3 +218,21 @@ void Onset::updateSeekLabel( double audioPosition ) {
 
     ui->audioSeekLabel->setText( seekLabelText );
 }
+
+void Onset::showLiveOnset( double time, float strength ) {
+    Q_UNUSED( strength );
+    liveOnsetTime = time;
+}
+
+//level of the hop the stream's DSP last went through, with the last onset the live detection found;
+//BASS runs the DSP when it fills the playback buffer, so both are that buffer's length ahead of what's heard
+void Onset::showLiveLevel( double time, float rms ) {
+    Q_UNUSED( time );
+    double level = 20.0 * log10( qMax( rms, 1e-5f ) );
+    QString liveText = QString( "%1 dB" ).arg( level, 0, 'f', 1 );
+    if ( liveOnsetTime >= 0.0 ) {
+        liveText += QString( ", onset %1" ).arg( liveOnsetTime, 0, 'f', 2 );
+    }
+
+    ui->liveAnalysisLabel->setText( liveText );
+}
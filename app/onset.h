@@ -9,6 +9,7 @@
 #include "audio.h"
 #include "audioplot.h"
 #include "transform.h"
+#include "sampleprocessingdialog.h"
 
 namespace Ui {
     class Onset;
@@ -27,12 +28,17 @@ private:
     Audio                               *audio;
     QString                             audioFilePath;
     QTimer                              *seekTimer;
+    QTimer                              *audioInfoTimer;
+    SampleProcessingDialog              *progressDialog;
 
     double                              audioDuration;
+    double                              liveOnsetTime;
     void                                updateSeekSlider( double audioPosition );
     void                                updateSeekLabel( double audioPosition );
     void                                updateAudioTitleLabel();
     void                                loadAudioFile( const QString &audioFilePath );
+    void                                applyAnalysisOptions();
+    void                                produceAudioInfo();
 
 private slots:
     void                                loadAudioFile();
@@ -42,13 +48,18 @@ private slots:
     void                                seek( int seconds );
     void                                seek( double seconds );
     void                                updateSeekInfo();
+    void                                showLiveOnset( double time, float strength );
+    void                                showLiveLevel( double time, float rms );
 
     //plot
     void                                showAudioInfo();
     void                                showOnset();
     void                                showStress();
     void                                showStressFormatted();
+    void                                scheduleAudioInfoUpdate();
     void                                updateAudioInfo();
+    void                                showAudioInfoProgress( int processed, int total );
+    void                                showProducedAudioInfo( bool produced );
 };
 
 #endif // ONSET_H
@@ -22,8 +22,6 @@ void SampleProcessingDialog::setSamplesToProcess( int samples ) {
 
 void SampleProcessingDialog::setSamplesProcessed( int samples ) {
     ui->progressBar->setValue( samples );
-
-    QApplication::processEvents();
 }
 
 void SampleProcessingDialog::addSampleProcessed( int sampleProcessed ) {
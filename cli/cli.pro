@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# onset-cli, the analysis core without a window
+# or an audio device, for scripts and pipelines
+#
+#-------------------------------------------------
+
+QT       = core
+
+TARGET = onset-cli
+TEMPLATE = app
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+include(../core/core.pri)
+
+SOURCES += main.cpp
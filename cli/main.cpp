@@ -0,0 +1,349 @@
+#include "analysisoptions.h"
+#include "audioanalysis.h"
+#include "decodechannelsource.h"
+#include "livetap.h"
+#include "rawpcmsource.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <cstdio>
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+//onset-cli [options] <audio files...>
+//analyses files one after another and streams the results, by default one JSON object per line on stdout,
+//a file named - is raw pcm read from stdin.
+//with --live the files are fed to a LiveTap at the pace a playing channel's DSP would see them,
+//and each onset is printed as a JSON line once the live detection finds it
+
+static QJsonArray toJsonArray( const QVector<float> &values ) {
+    QJsonArray array;
+    for ( int i = 0 ; i < values.size() ; i++ ) {
+        array.append( values.at( i ) );
+    }
+    return array;
+}
+
+static QByteArray toJson( const AudioAnalysis &analysis, const QString &audioFilePath, const AnalysisResult &result ) {
+    static const char *periodTypeNames[] = { "safe", "caution", "danger" };
+
+    QJsonArray periods;
+    for ( int i = 0 ; i + 2 < result.periods.size() ; i += 3 ) {
+        int periodType = qBound( 0, ( int ) result.periods.at( i ), 2 );
+        QJsonObject period;
+        period["type"] = periodTypeNames[periodType];
+        period["begin"] = result.periods.at( i + 1 );
+        period["end"] = result.periods.at( i + 2 );
+        periods.append( period );
+    }
+
+    QJsonObject object;
+    object["path"] = audioFilePath;
+    object["hash"] = analysis.getAudioHash();
+    object["duration"] = result.duration;
+    object["meanAll"] = result.meanAll;
+    object["onsetFrameDuration"] = result.onsetFrameDuration;
+    object["stressStep"] = result.stressStep;
+    object["onsetTime"] = toJsonArray( result.onsetTime );
+    object["onsetValue"] = toJsonArray( result.onsetValue );
+    object["stressTime"] = toJsonArray( result.stressTime );
+    object["stressValue"] = toJsonArray( result.stressValue );
+    object["periods"] = periods;
+
+    return QJsonDocument( object ).toJson( QJsonDocument::Compact ) + "\n";
+}
+
+//<file name>.json or <file name>.onset in the output directory
+static QString getOutputFileName( const QString &audioFilePath, bool binary ) {
+    QString baseName = audioFilePath == "-" ? QString( "stdin" ) : QFileInfo( audioFilePath ).completeBaseName();
+    return baseName + ( binary ? ".onset" : ".json" );
+}
+
+//prints onsets on the tap's thread, stdout isn't touched by the main thread meanwhile
+class LiveOnsetPrinter : public OnlineOnsetDetector::Listener {
+
+public:
+                                        LiveOnsetPrinter( QFile *output, const QString &audioFilePath ) :
+        output( output ), audioFilePath( audioFilePath ), written( true ) {}
+
+    void                                onsetDetected( double time, float strength ) {
+        QJsonObject object;
+        object["path"] = audioFilePath;
+        object["time"] = time;
+        object["strength"] = strength;
+        QByteArray line = QJsonDocument( object ).toJson( QJsonDocument::Compact ) + "\n";
+        written = output->write( line ) == line.size() && output->flush() && written;
+    }
+
+    void                                levelMeasured( double time, float rms ) {
+        Q_UNUSED( time );
+        Q_UNUSED( rms );
+    }
+
+    //false once a line couldn't be written, read after the tap's thread finished
+    bool                                isWritten() const {
+        return written;
+    }
+
+private:
+    QFile                               *output;
+    QString                             audioFilePath;
+    bool                                written;
+};
+
+//writes the source in blocks of BASS' default 10 ms update period, speed 0 doesn't wait between them;
+//returns the sample frames the tap dropped because its thread fell behind
+static int analyseLive( LiveTap &tap, AudioSource *source, int frequency, int channels, double speed ) {
+    int blockFrames = qMax( 1, frequency / 100 );
+    QVector<float> block( blockFrames * channels );
+    qint64 writtenFrames = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    tap.start();
+    while ( true ) {
+        int sampleCount = source->read( block.data(), block.size() );
+        if ( sampleCount == 0 ) {
+            break;
+        }
+
+        tap.write( block.constData(), sampleCount );
+        writtenFrames += sampleCount / channels;
+
+        if ( speed > 0.0 ) {
+            qint64 dueNanoseconds = writtenFrames * 1000000000.0 / ( frequency * speed );
+            qint64 aheadMicroseconds = ( dueNanoseconds - timer.nsecsElapsed() ) / 1000;
+            if ( aheadMicroseconds > 0 ) {
+                QThread::usleep( aheadMicroseconds );
+            }
+        }
+    }
+    tap.stop();
+    tap.wait();
+
+    return tap.getDroppedFrameCount();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName( "onset-cli" );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( "Onset and stress analysis of audio files." );
+    parser.addHelpOption();
+    parser.addPositionalArgument( "files", "Audio files to analyse, - for raw pcm on stdin.", "<files...>" );
+    QCommandLineOption formatOption( QStringList() << "f" << "format", "Output format, json (one line per file) or onset (binary audio info file).", "format", "json" );
+    QCommandLineOption outputOption( QStringList() << "o" << "output-dir", "Write <file name>.json or <file name>.onset there instead of to stdout.", "directory" );
+    QCommandLineOption threadsOption( "threads", "Number of analysis threads.", "count", QString::number( QThread::idealThreadCount() ) );
+    QCommandLineOption cacheOption( "cache", "Keep decoded features in <directory> so a rerun with other onset options skips decoding.", "directory" );
+    QCommandLineOption sampleFormatOption( "sample-format", "Raw pcm samples on stdin, f32 or s16, interleaved little endian.", "format", "f32" );
+    QCommandLineOption rateOption( "rate", "Sample rate of raw pcm on stdin.", "hz", "44100" );
+    QCommandLineOption channelsOption( "channels", "Channel count of raw pcm on stdin.", "count", "2" );
+    QCommandLineOption liveOption( "live", "Detect onsets as if the files were playing and print each one when it's found." );
+    QCommandLineOption lookaheadOption( "lookahead", "Frames the live threshold window looks ahead.", "frames", "2" );
+    QCommandLineOption speedOption( "speed", "Playback speed of --live, 0 for as fast as the input comes.", "factor", "1" );
+    parser.addOption( formatOption );
+    parser.addOption( outputOption );
+    parser.addOption( threadsOption );
+    parser.addOption( cacheOption );
+    AnalysisOptions::addTo( parser );
+    parser.addOption( sampleFormatOption );
+    parser.addOption( rateOption );
+    parser.addOption( channelsOption );
+    parser.addOption( liveOption );
+    parser.addOption( lookaheadOption );
+    parser.addOption( speedOption );
+    parser.process( a );
+
+    QStringList audioFilePaths = parser.positionalArguments();
+    if ( audioFilePaths.isEmpty() ) {
+        parser.showHelp( 1 );
+    }
+
+    QString format = parser.value( formatOption );
+    bool binary = format == "onset";
+    if ( !binary && format != "json" ) {
+        qWarning() << "unknown format" << format;
+        return 1;
+    }
+
+    QString outputDirectoryPath = parser.value( outputOption );
+    if ( outputDirectoryPath.isEmpty() && binary && audioFilePaths.size() > 1 ) {
+        qWarning() << "several binary results need --output-dir";
+        return 1;
+    }
+    if ( !outputDirectoryPath.isEmpty() && !QDir().mkpath( outputDirectoryPath ) ) {
+        qWarning() << "can't create" << outputDirectoryPath;
+        return 1;
+    }
+
+    //like a/song.mp3 and b/song.flac, which would overwrite each other's results
+    if ( !outputDirectoryPath.isEmpty() ) {
+        QMap<QString, QString> outputFileNames;
+        for ( int i = 0 ; i < audioFilePaths.size() ; i++ ) {
+            QString outputFileName = getOutputFileName( audioFilePaths.at( i ), binary );
+            if ( outputFileNames.contains( outputFileName ) ) {
+                qWarning() << audioFilePaths.at( i ) << "and" << outputFileNames.value( outputFileName ) << "would both be written to" << outputFileName;
+                return 1;
+            }
+            outputFileNames.insert( outputFileName, audioFilePaths.at( i ) );
+        }
+    }
+
+    AnalysisOptions analysisOptions;
+    if ( !analysisOptions.read( parser ) ) {
+        return 1;
+    }
+
+    QString sampleFormat = parser.value( sampleFormatOption );
+    int rate = parser.value( rateOption ).toInt();
+    int channels = parser.value( channelsOption ).toInt();
+    if ( ( sampleFormat != "f32" && sampleFormat != "s16" ) || rate <= 0 || channels <= 0 ) {
+        qWarning() << "raw pcm format out of range";
+        return 1;
+    }
+    bool live = parser.isSet( liveOption );
+    int lookahead = parser.value( lookaheadOption ).toInt();
+    double speed = parser.value( speedOption ).toDouble();
+    if ( live && ( binary || !outputDirectoryPath.isEmpty() || lookahead < 0 || speed < 0.0 ) ) {
+        qWarning() << "--live prints json onsets on stdout, with a lookahead and speed of at least 0";
+        return 1;
+    }
+    if ( audioFilePaths.count( "-" ) > 1 ) {
+        qWarning() << "stdin can be read only once";
+        return 1;
+    }
+
+    //segments and thresholds of a file run on the global pool
+    QThreadPool::globalInstance()->setMaxThreadCount( qMax( 1, parser.value( threadsOption ).toInt() ) );
+
+    //decoding channels only, no output device is opened
+    if ( !BASS_Init( 0, 44100, 0, NULL, NULL ) ) {
+        qWarning() << "can't initialize BASS, error" << BASS_ErrorGetCode();
+        return 1;
+    }
+
+#ifdef Q_OS_WIN
+    _setmode( _fileno( stdout ), _O_BINARY );
+    _setmode( _fileno( stdin ), _O_BINARY );
+#endif
+    QFile standardOutput;
+    if ( !standardOutput.open( stdout, QIODevice::WriteOnly ) ) {
+        qWarning() << "can't write to stdout";
+        BASS_Free();
+        return 1;
+    }
+
+    QFile standardInput;
+    standardInput.open( stdin, QIODevice::ReadOnly );
+    RawPcmSource standardInputSource( &standardInput, sampleFormat == "s16" ? RawPcmSource::SAMPLE_FORMAT_INT16 : RawPcmSource::SAMPLE_FORMAT_FLOAT32 );
+
+    int failedCount = 0;
+    for ( int i = 0 ; i < audioFilePaths.size() ; i++ ) {
+        const QString &audioFilePath = audioFilePaths.at( i );
+
+        if ( live ) {
+            HSTREAM decodeChannel = 0;
+            BASS_CHANNELINFO channelInfo;
+            channelInfo.freq = rate;
+            channelInfo.chans = channels;
+            if ( audioFilePath != "-" ) {
+                decodeChannel = BASS_StreamCreateFile( false, audioFilePath.toStdString().c_str(), 0, 0, BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE );
+                if ( !decodeChannel ) {
+                    qWarning() << "can't decode" << audioFilePath << "BASS error" << BASS_ErrorGetCode();
+                    failedCount++;
+                    continue;
+                }
+                BASS_ChannelGetInfo( decodeChannel, &channelInfo );
+            }
+
+            DecodeChannelSource decodeChannelSource( decodeChannel );
+            AudioSource *source = decodeChannel ? ( AudioSource * ) &decodeChannelSource : &standardInputSource;
+
+            LiveTap tap( channelInfo.freq, channelInfo.chans, lookahead, analysisOptions.window );
+            analysisOptions.applyTo( tap.getDetector() );
+            LiveOnsetPrinter printer( &standardOutput, audioFilePath );
+            tap.setListener( &printer );
+
+            int droppedFrames = analyseLive( tap, source, channelInfo.freq, channelInfo.chans, speed );
+            qWarning().nospace() << audioFilePath << ": latency at most " << tap.getDetector().getLatencySeconds()
+                                 << " s, " << droppedFrames << " sample frames dropped";
+            if ( !printer.isWritten() ) {
+                qWarning() << "can't write the onsets of" << audioFilePath;
+                failedCount++;
+            }
+
+            if ( decodeChannel ) {
+                BASS_StreamFree( decodeChannel );
+            }
+            continue;
+        }
+
+        AudioAnalysis analysis;
+        analysis.setDataDirectory( parser.value( cacheOption ) );
+        analysisOptions.applyTo( analysis );
+
+        bool opened = true;
+        if ( audioFilePath == "-" ) {
+            analysis.setSource( &standardInputSource, rate, channels );
+        } else {
+            opened = analysis.openAudio( audioFilePath );
+        }
+
+        AnalysisResult result;
+        if ( !opened || !analysis.analyse( result, analysisOptions.pcmStep, analysisOptions.stressWindow ) ) {
+            qWarning() << "failed to analyse" << audioFilePath;
+            failedCount++;
+            continue;
+        }
+
+        //a result file replaces an older one only once it's completely written
+        QSaveFile outputFile;
+        QIODevice *output = &standardOutput;
+        if ( !outputDirectoryPath.isEmpty() ) {
+            outputFile.setFileName( QDir( outputDirectoryPath ).filePath( getOutputFileName( audioFilePath, binary ) ) );
+            if ( !outputFile.open( QIODevice::WriteOnly ) ) {
+                qWarning() << "can't write" << outputFile.fileName();
+                failedCount++;
+                continue;
+            }
+            output = &outputFile;
+        }
+
+        QByteArray json;
+        if ( !binary ) {
+            json = toJson( analysis, audioFilePath, result );
+        }
+        bool written = binary ? AnalysisFile::write( output, result ) : output->write( json ) == json.size();
+
+        //results leave as soon as they're ready, for whatever reads the pipe;
+        //the write only buffered them, a full disk or a closed pipe shows up here
+        if ( output == &standardOutput ) {
+            written = written && standardOutput.flush();
+        } else if ( written ) {
+            written = outputFile.commit();
+        } else {
+            outputFile.cancelWriting();
+        }
+        if ( !written ) {
+            qWarning() << "can't write the result of" << audioFilePath;
+            failedCount++;
+        }
+    }
+
+    BASS_Free();
+
+    return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,303 @@
+#include "analysisbatch.h"
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+
+class BatchJob : public QRunnable {
+
+public:
+                                        BatchJob( AnalysisBatch *batch, const QString &audioFilePath ) :
+        batch( batch ), audioFilePath( audioFilePath ) {}
+
+    void                                run() {
+        batch->analyseFile( audioFilePath );
+        batch->queueSlots->release();
+    }
+
+private:
+    AnalysisBatch                       *batch;
+    QString                             audioFilePath;
+};
+
+AnalysisBatch::AnalysisBatch() :
+    threadCount( QThread::idealThreadCount() ),
+    decoderConcurrency( qMax( 1, QThread::idealThreadCount() / 2 ) ),
+    dataDirectoryPath( "D:\\audios" ),
+    pcmStep( 512 ),
+    window( 256 ),
+    verbose( false ),
+    onsetThresholdWindowSize( 20 ),
+    onsetMultiplier( 1.5 ),
+    onsetWindow( true ),
+    peakPreWindow( 0 ),
+    peakPostWindow( 1 ),
+    peakMinInterval( 0 ),
+    detectionFunction( AudioAnalysis::DETECTION_FUNCTION_FLUX ),
+    multiResolution( false ),
+    pool( 0 ),
+    queueSlots( 0 ),
+    decoderSlots( 0 ) {
+}
+
+void AnalysisBatch::setThreadCount( int threadCount ) {
+    this->threadCount = qMax( 1, threadCount );
+}
+
+void AnalysisBatch::setDecoderConcurrency( int decoderConcurrency ) {
+    this->decoderConcurrency = qMax( 1, decoderConcurrency );
+}
+
+void AnalysisBatch::setDataDirectory( const QString &dataDirectoryPath ) {
+    this->dataDirectoryPath = dataDirectoryPath;
+}
+
+void AnalysisBatch::setManifestPath( const QString &manifestPath ) {
+    this->manifestPath = manifestPath;
+}
+
+void AnalysisBatch::setAnalysisOptions( int pcmStep, int window ) {
+    this->pcmStep = qMax( 1, pcmStep );
+    this->window = qMax( 1, window );
+}
+
+void AnalysisBatch::setOnsetOptions( int onsetThresholdWindowSize, float onsetMultiplier, bool window ) {
+    this->onsetThresholdWindowSize = onsetThresholdWindowSize;
+    this->onsetMultiplier = onsetMultiplier;
+    this->onsetWindow = window;
+}
+
+void AnalysisBatch::setPeakOptions( int preWindow, int postWindow, int minInterval ) {
+    peakPreWindow = preWindow;
+    peakPostWindow = postWindow;
+    peakMinInterval = minInterval;
+}
+
+void AnalysisBatch::setDetectionFunction( AudioAnalysis::DETECTION_FUNCTION detectionFunction ) {
+    this->detectionFunction = detectionFunction;
+}
+
+void AnalysisBatch::setMultiResolution( bool multiResolution ) {
+    this->multiResolution = multiResolution;
+}
+
+void AnalysisBatch::setVerbose( bool verbose ) {
+    this->verbose = verbose;
+}
+
+bool AnalysisBatch::analyse( const QStringList &paths ) {
+    if ( !QDir().mkpath( dataDirectoryPath ) ) {
+        qWarning() << "can't create" << dataDirectoryPath;
+        return false;
+    }
+
+    analysedCount = 0;
+    skippedCount = 0;
+    failedCount = 0;
+    manifest.clear();
+    scheduledPaths.clear();
+
+    //a file's analysis already spreads over the global pool, files get their own pool
+    //so a job waiting for its segments never holds a thread the segments need
+    QThreadPool filePool;
+    filePool.setMaxThreadCount( threadCount );
+    pool = &filePool;
+
+    //every decoding file holds its pieces, extractors and pcm,
+    //fewer decoders than threads keep a batch of long tracks in memory
+    QSemaphore decoders( decoderConcurrency );
+    decoderSlots = &decoders;
+
+    //bounded job queue, a whole library isn't queued at once
+    QSemaphore queue( threadCount * 4 );
+    queueSlots = &queue;
+
+    for ( int i = 0 ; i < paths.size() ; i++ ) {
+        this->schedulePath( paths.at( i ), true );
+    }
+
+    filePool.waitForDone();
+    pool = 0;
+    queueSlots = 0;
+    decoderSlots = 0;
+
+    bool written = manifestPath.isEmpty() || this->writeManifest();
+    return written && failedCount.load() == 0;
+}
+
+int AnalysisBatch::getAnalysedCount() const {
+    return analysedCount.load();
+}
+
+int AnalysisBatch::getSkippedCount() const {
+    return skippedCount.load();
+}
+
+int AnalysisBatch::getFailedCount() const {
+    return failedCount.load();
+}
+
+//a directory is scanned with its subdirectories, a list file names one file or directory per line,
+//relative to the list, anything else is taken for an audio file
+void AnalysisBatch::schedulePath( const QString &path, bool expandLists ) {
+    QFileInfo fileInfo( path );
+    if ( fileInfo.isDir() ) {
+        QDirIterator it( path, getAudioFileFilters(), QDir::Files, QDirIterator::Subdirectories );
+        while ( it.hasNext() ) {
+            this->scheduleFile( it.next() );
+        }
+        return;
+    }
+
+    if ( expandLists && getListFileSuffixes().contains( fileInfo.suffix().toLower() ) ) {
+        QFile listFile( path );
+        if ( !listFile.open( QIODevice::ReadOnly | QIODevice::Text ) ) {
+            qWarning() << "can't read" << path;
+            failedCount.ref();
+            return;
+        }
+
+        QDir listDirectory = fileInfo.absoluteDir();
+        QTextStream stream( &listFile );
+        while ( !stream.atEnd() ) {
+            QString line = stream.readLine().trimmed();
+            if ( line.isEmpty() || line.startsWith( '#' ) ) {
+                continue;
+            }
+            this->schedulePath( listDirectory.absoluteFilePath( line ), false );
+        }
+        return;
+    }
+
+    this->scheduleFile( path );
+}
+
+//the same file named twice would be analysed by two jobs at once
+void AnalysisBatch::scheduleFile( const QString &audioFilePath ) {
+    QString canonicalPath = QFileInfo( audioFilePath ).canonicalFilePath();
+    if ( canonicalPath.isEmpty() ) {
+        canonicalPath = audioFilePath;
+    }
+    if ( scheduledPaths.contains( canonicalPath ) ) {
+        return;
+    }
+    scheduledPaths.insert( canonicalPath );
+
+    queueSlots->acquire();
+    pool->start( new BatchJob( this, canonicalPath ) );
+}
+
+void AnalysisBatch::analyseFile( const QString &audioFilePath ) {
+    QElapsedTimer timer;
+    timer.start();
+
+    AudioAnalysis analysis;
+    analysis.setDataDirectory( dataDirectoryPath );
+    analysis.setOnsetOptions( onsetThresholdWindowSize, onsetMultiplier, onsetWindow );
+    analysis.setPeakOptions( peakPreWindow, peakPostWindow, peakMinInterval );
+    analysis.setDetectionFunction( detectionFunction );
+    analysis.setMultiResolution( multiResolution );
+    BATCH_RESULT result = this->process( analysis, audioFilePath );
+
+    switch ( result ) {
+        case BATCH_ANALYSED:
+            analysedCount.ref();
+            if ( verbose ) {
+                qInfo() << "analysed" << audioFilePath;
+            }
+            break;
+
+        case BATCH_SKIPPED:
+            skippedCount.ref();
+            break;
+
+        case BATCH_FAILED:
+            failedCount.ref();
+            qWarning() << "failed to analyse" << audioFilePath;
+            break;
+    }
+
+    ManifestEntry entry;
+    entry.audioFilePath = audioFilePath;
+    entry.audioHash = analysis.getAudioHash();
+    entry.result = result;
+    entry.seconds = timer.elapsed() / 1000.0;
+
+    QMutexLocker locker( &manifestMutex );
+    manifest.append( entry );
+}
+
+AnalysisBatch::BATCH_RESULT AnalysisBatch::process( AudioAnalysis &analysis, const QString &audioFilePath ) {
+    if ( !analysis.openAudio( audioFilePath ) ) {
+        return BATCH_FAILED;
+    }
+
+    if ( analysis.isAudioInfoFileUpToDate( pcmStep, window ) ) {
+        return BATCH_SKIPPED;
+    }
+
+    decoderSlots->acquire();
+    bool produced = analysis.produceAudioInfoFile( pcmStep, window );
+    decoderSlots->release();
+
+    return produced ? BATCH_ANALYSED : BATCH_FAILED;
+}
+
+//tab separated, one line per file in path order whatever order the jobs finished in
+bool AnalysisBatch::writeManifest() {
+    std::sort( manifest.begin(), manifest.end(), isEarlier );
+
+    QSaveFile manifestFile( manifestPath );
+    if ( !manifestFile.open( QIODevice::WriteOnly | QIODevice::Text ) ) {
+        qWarning() << "can't write" << manifestPath;
+        return false;
+    }
+
+    QTextStream stream( &manifestFile );
+    stream.setCodec( "UTF-8" );
+    stream << "# analysed " << analysedCount.load()
+           << " skipped " << skippedCount.load()
+           << " failed " << failedCount.load() << "\n";
+    stream << "result\thash\tseconds\tpath\n";
+    for ( int i = 0 ; i < manifest.size() ; i++ ) {
+        const ManifestEntry &entry = manifest.at( i );
+        stream << getResultName( entry.result ) << "\t"
+               << ( entry.audioHash.isEmpty() ? "-" : entry.audioHash ) << "\t"
+               << QString::number( entry.seconds, 'f', 3 ) << "\t"
+               << QDir::toNativeSeparators( entry.audioFilePath ) << "\n";
+    }
+    stream.flush();
+
+    return stream.status() == QTextStream::Ok && manifestFile.commit();
+}
+
+bool AnalysisBatch::isEarlier( const ManifestEntry &a, const ManifestEntry &b ) {
+    return a.audioFilePath < b.audioFilePath;
+}
+
+//what BASS decodes without plugins
+QStringList AnalysisBatch::getAudioFileFilters() {
+    return QStringList() << "*.mp3" << "*.mp2" << "*.mp1" << "*.wav" << "*.ogg" << "*.aif" << "*.aiff";
+}
+
+QStringList AnalysisBatch::getListFileSuffixes() {
+    return QStringList() << "txt" << "lst" << "m3u" << "m3u8";
+}
+
+QString AnalysisBatch::getResultName( BATCH_RESULT result ) {
+    switch ( result ) {
+        case BATCH_ANALYSED:
+            return "analysed";
+        case BATCH_SKIPPED:
+            return "skipped";
+        case BATCH_FAILED:
+            return "failed";
+    }
+    return QString();
+}
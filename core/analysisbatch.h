@@ -0,0 +1,94 @@
+#ifndef ANALYSISBATCH_H
+#define ANALYSISBATCH_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSet>
+#include <QSemaphore>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+#include "audioanalysis.h"
+
+//analyses the audio files of directories and file lists without a window, one job per file,
+//files with an up-to-date audio info file and cache are skipped, so an interrupted run resumes
+class AnalysisBatch {
+
+public:
+                                        AnalysisBatch();
+
+    void                                setThreadCount( int threadCount );
+    void                                setDecoderConcurrency( int decoderConcurrency );
+    void                                setDataDirectory( const QString &dataDirectoryPath );
+    void                                setManifestPath( const QString &manifestPath );
+    void                                setAnalysisOptions( int pcmStep, int window );
+    void                                setOnsetOptions( int onsetThresholdWindowSize, float onsetMultiplier, bool window );
+    void                                setPeakOptions( int preWindow, int postWindow, int minInterval );
+    void                                setDetectionFunction( AudioAnalysis::DETECTION_FUNCTION detectionFunction );
+    void                                setMultiResolution( bool multiResolution );
+    void                                setVerbose( bool verbose );
+
+    bool                                analyse( const QStringList &paths );
+
+    int                                 getAnalysedCount() const;
+    int                                 getSkippedCount() const;
+    int                                 getFailedCount() const;
+
+private:
+    enum                                BATCH_RESULT {
+        BATCH_ANALYSED,
+        BATCH_SKIPPED,
+        BATCH_FAILED
+    };
+
+    struct                              ManifestEntry {
+        QString                         audioFilePath;
+        QString                         audioHash;
+        BATCH_RESULT                    result;
+        double                          seconds;
+    };
+
+    int                                 threadCount;
+    int                                 decoderConcurrency;
+    QString                             dataDirectoryPath;
+    QString                             manifestPath;
+    int                                 pcmStep;
+    int                                 window;
+    bool                                verbose;
+
+    //applied to every file's analysis
+    int                                 onsetThresholdWindowSize;
+    float                               onsetMultiplier;
+    bool                                onsetWindow;
+    int                                 peakPreWindow;
+    int                                 peakPostWindow;
+    int                                 peakMinInterval;
+    AudioAnalysis::DETECTION_FUNCTION   detectionFunction;
+    bool                                multiResolution;
+
+    QThreadPool                         *pool;
+    QSemaphore                          *queueSlots;
+    QSemaphore                          *decoderSlots;
+    QAtomicInt                          analysedCount;
+    QAtomicInt                          skippedCount;
+    QAtomicInt                          failedCount;
+
+    QMutex                              manifestMutex;
+    QVector<ManifestEntry>              manifest;
+    QSet<QString>                       scheduledPaths;
+
+    void                                schedulePath( const QString &path, bool expandLists );
+    void                                scheduleFile( const QString &audioFilePath );
+    void                                analyseFile( const QString &audioFilePath );
+    BATCH_RESULT                        process( AudioAnalysis &analysis, const QString &audioFilePath );
+    bool                                writeManifest();
+
+    static QStringList                  getAudioFileFilters();
+    static QStringList                  getListFileSuffixes();
+    static QString                      getResultName( BATCH_RESULT result );
+    static bool                         isEarlier( const ManifestEntry &a, const ManifestEntry &b );
+
+    friend class                        BatchJob;
+};
+
+#endif // ANALYSISBATCH_H
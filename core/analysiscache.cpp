@@ -0,0 +1,102 @@
+#include "analysiscache.h"
+
+AnalysisCache::AnalysisCache() {
+    this->clear();
+}
+
+bool AnalysisCache::load( const QString &cacheFilePath ) {
+    this->clear();
+
+    QFile cacheFile( cacheFilePath );
+    if ( !cacheFile.open( QIODevice::ReadOnly ) ) {
+        return false;
+    }
+
+    QDataStream inp( &cacheFile );
+    inp.setVersion( QDataStream::Qt_5_0 );
+    inp.setByteOrder( QDataStream::LittleEndian );
+    inp.setFloatingPointPrecision( QDataStream::SinglePrecision );
+
+    quint32 magic;
+    quint32 version;
+    inp >> magic >> version;
+    if ( magic != MAGIC || version != VERSION ) {
+        return false;
+    }
+
+    qint32 frequency, channels, fluxWindow, fluxHopSize, fluxFftSize, pcmStep;
+    inp >> frequency >> channels;
+    inp >> fluxWindow >> fluxHopSize >> fluxFftSize >> flux >> features;
+    inp >> resolutionFrameSizes >> resolutionFlux >> resolutionSuperFlux;
+    inp >> pcmStep >> pcm;
+
+    if ( inp.status() != QDataStream::Ok ) {
+        this->clear();
+        return false;
+    }
+
+    this->frequency = frequency;
+    this->channels = channels;
+    this->fluxWindow = fluxWindow;
+    this->fluxHopSize = fluxHopSize;
+    this->fluxFftSize = fluxFftSize;
+    this->pcmStep = pcmStep;
+
+    return true;
+}
+
+bool AnalysisCache::save( const QString &cacheFilePath ) const {
+    QSaveFile cacheFile( cacheFilePath );
+    if ( !cacheFile.open( QIODevice::WriteOnly ) ) {
+        return false;
+    }
+
+    QDataStream out( &cacheFile );
+    out.setVersion( QDataStream::Qt_5_0 );
+    out.setByteOrder( QDataStream::LittleEndian );
+    out.setFloatingPointPrecision( QDataStream::SinglePrecision );
+
+    out << MAGIC << VERSION;
+    out << ( qint32 ) frequency << ( qint32 ) channels;
+    out << ( qint32 ) fluxWindow << ( qint32 ) fluxHopSize << ( qint32 ) fluxFftSize << flux << features;
+    out << resolutionFrameSizes << resolutionFlux << resolutionSuperFlux;
+    out << ( qint32 ) pcmStep << pcm;
+
+    if ( out.status() != QDataStream::Ok ) {
+        cacheFile.cancelWriting();
+        return false;
+    }
+
+    return cacheFile.commit();
+}
+
+void AnalysisCache::clear() {
+    frequency = 0;
+    channels = 0;
+    fluxWindow = -1;
+    fluxHopSize = 0;
+    fluxFftSize = 0;
+    flux.clear();
+    features.clear();
+    resolutionFrameSizes.clear();
+    resolutionFlux.clear();
+    resolutionSuperFlux.clear();
+    pcmStep = 0;
+    pcm.clear();
+}
+
+bool AnalysisCache::hasFlux( int fluxWindow ) const {
+    return this->fluxWindow == fluxWindow && !flux.isEmpty();
+}
+
+bool AnalysisCache::hasPCM( int pcmStep ) const {
+    return this->pcmStep == pcmStep && !pcm.isEmpty();
+}
+
+bool AnalysisCache::hasResolutions( const QVector<int> &frameSizes ) const {
+    if ( frameSizes.isEmpty() ) {
+        return true;
+    }
+    return resolutionFrameSizes == frameSizes && resolutionFlux.size() == frameSizes.size() &&
+           resolutionSuperFlux.size() == frameSizes.size();
+}
@@ -0,0 +1,54 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+#include <QDataStream>
+#include <QMetaType>
+#include <QFile>
+#include <QSaveFile>
+#include <QVector>
+
+//analysis stages which don't depend on onset threshold options,
+//kept next to the audio info file so retuning a track skips decoding and FFT
+class AnalysisCache {
+
+public:
+                                        AnalysisCache();
+
+    bool                                load( const QString &cacheFilePath );
+    bool                                save( const QString &cacheFilePath ) const;
+    void                                clear();
+
+    bool                                hasFlux( int fluxWindow ) const;
+    bool                                hasPCM( int pcmStep ) const;
+    bool                                hasResolutions( const QVector<int> &frameSizes ) const;
+
+    int                                 frequency;
+    int                                 channels;
+
+    //raw spectral flux, one value per hop, flux[i] is at i * fluxHopSize / frequency seconds
+    int                                 fluxWindow;
+    int                                 fluxHopSize;
+    int                                 fluxFftSize;
+    QVector<float>                      flux;
+
+    //FeatureExtractor columns of the same frames, indexed by FeatureExtractor::FEATURE
+    QVector< QVector<float> >           features;
+
+    //flux and SuperFlux of the same hops from frames of resolutionFrameSizes[r] samples,
+    //only filled when multi-resolution detection asked for them
+    QVector<int>                        resolutionFrameSizes;
+    QVector< QVector<float> >           resolutionFlux;
+    QVector< QVector<float> >           resolutionSuperFlux;
+
+    //interleaved samples, every pcmStep-th one
+    int                                 pcmStep;
+    QVector<float>                      pcm;
+
+private:
+    static const quint32                MAGIC = 0x43464E4F;
+    static const quint32                VERSION = 5;
+};
+
+Q_DECLARE_METATYPE( AnalysisCache )
+
+#endif // ANALYSISCACHE_H
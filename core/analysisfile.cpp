@@ -0,0 +1,797 @@
+#include "analysisfile.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <qmath.h>
+#include <QSaveFile>
+
+static float readFloat( const uchar *data ) {
+    quint32 bits = qFromLittleEndian<quint32>( data );
+    float value;
+    memcpy( &value, &bits, sizeof( value ) );
+    return value;
+}
+
+static void writeFloat( float value, uchar *data ) {
+    quint32 bits;
+    memcpy( &bits, &value, sizeof( bits ) );
+    qToLittleEndian<quint32>( bits, data );
+}
+
+static double readDouble( const uchar *data ) {
+    quint64 bits = qFromLittleEndian<quint64>( data );
+    double value;
+    memcpy( &value, &bits, sizeof( value ) );
+    return value;
+}
+
+static void appendFloat( float value, QByteArray &out ) {
+    uchar data[4];
+    writeFloat( value, data );
+    out.append( ( const char * ) data, 4 );
+}
+
+static void appendDouble( double value, QByteArray &out ) {
+    quint64 bits;
+    uchar data[8];
+    memcpy( &bits, &value, sizeof( bits ) );
+    qToLittleEndian<quint64>( bits, data );
+    out.append( ( const char * ) data, 8 );
+}
+
+//LEB128, 7 bits per byte, high bit set on all but the last byte
+static void appendVarint( quint64 value, QByteArray &out ) {
+    while ( value >= 0x80 ) {
+        out.append( ( char ) ( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+    }
+    out.append( ( char ) value );
+}
+
+static bool readVarint( const uchar *&data, const uchar *end, quint64 &value ) {
+    value = 0;
+    for ( int shift = 0 ; shift < 64 && data < end ; shift += 7 ) {
+        uchar byte = *data++;
+        value |= ( quint64 ) ( byte & 0x7F ) << shift;
+        if ( !( byte & 0x80 ) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static quint64 zigzag( qint64 value ) {
+    return ( ( quint64 ) value << 1 ) ^ ( quint64 ) ( value >> 63 );
+}
+
+static qint64 unzigzag( quint64 value ) {
+    return ( qint64 ) ( value >> 1 ) ^ -( qint64 ) ( value & 1 );
+}
+
+static qint64 align( qint64 offset, int alignment ) {
+    return ( offset + alignment - 1 ) / alignment * alignment;
+}
+
+//values are normalized to about [0, 1], 2^-16 is far below one pixel of the plot
+const float AnalysisFile::VALUE_QUANTUM = 1.0 / 65536;
+//keys are stored as float, allow them to drift this many steps off the grid
+const double AnalysisFile::KEY_TOLERANCE = 0.05;
+
+AnalysisFile::AnalysisFile() :
+    opened( false ), meanAll( 0.0 ), duration( 0.0 ), blockDuration( 0.0 ), optionsFingerprint( 0 ) {
+}
+
+AnalysisFile::~AnalysisFile() {
+    this->close();
+}
+
+bool AnalysisFile::open( const QString &analysisFilePath ) {
+    this->close();
+
+    file.setFileName( analysisFilePath );
+    if ( !file.open( QIODevice::ReadOnly ) || !this->parse() ) {
+        this->close();
+        return false;
+    }
+
+    opened = true;
+
+    return true;
+}
+
+bool AnalysisFile::openLegacy( const QString &audioInfoFilePath ) {
+    this->close();
+
+    QFile audioInfoFile( audioInfoFilePath );
+    if ( !audioInfoFile.open( QIODevice::ReadOnly ) || audioInfoFile.size() <= 0 ) {
+        return false;
+    }
+
+    qint64 size = audioInfoFile.size();
+    const char *text = ( const char * ) audioInfoFile.map( 0, size );
+    if ( !text ) {
+        return false;
+    }
+
+    AnalysisResult result;
+    bool parsed = parseLegacy( text, size, result );
+
+    audioInfoFile.unmap( ( uchar * ) text );
+    audioInfoFile.close();
+
+    if ( !parsed ) {
+        return false;
+    }
+
+    buffer = serialize( result );
+    if ( !this->parse() ) {
+        this->close();
+        return false;
+    }
+
+    opened = true;
+
+    return true;
+}
+
+bool AnalysisFile::parseLegacy( const char *text, qint64 size, AnalysisResult &result ) {
+    const char *textEnd = text + size;
+
+    //the old writer only wrote text, a zero byte means a binary file like one of another version
+    if ( memchr( text, 0, size ) ) {
+        return false;
+    }
+
+    //every point takes one line, so the line count bounds both series
+    int lineCount = ( int ) std::count( text, textEnd, '\n' ) + 1;
+
+    result = AnalysisResult();
+    result.onsetTime.reserve( lineCount );
+    result.onsetValue.reserve( lineCount );
+    result.stressTime.reserve( lineCount );
+    result.stressValue.reserve( lineCount );
+
+    enum {
+        READING_ONSET,
+        READING_MEAN,
+        READING_STRESS,
+        READING_PERIODS
+    } reading = READING_ONSET;
+    bool foundMean = false;
+
+    const char *line = text;
+    while ( line < textEnd ) {
+        const char *lineEnd = ( const char * ) memchr( line, '\n', textEnd - line );
+        if ( !lineEnd ) {
+            lineEnd = textEnd;
+        }
+        const char *next = lineEnd + 1;
+        if ( lineEnd > line && lineEnd[-1] == '\r' ) {
+            lineEnd--;
+        }
+
+        int length = lineEnd - line;
+        if ( length == 3 && memcmp( line, "PCM", 3 ) == 0 ) {
+            reading = READING_MEAN;
+        } else if ( length == 12 && memcmp( line, "PCMFormatted", 12 ) == 0 ) {
+            reading = READING_PERIODS;
+        } else {
+            double fields[3];
+            int fieldCount = parseLegacyFields( line, lineEnd, fields, 3 );
+            if ( reading == READING_MEAN ) {
+                foundMean = fieldCount == 1;
+                result.meanAll = foundMean ? fields[0] : 0.0;
+                reading = READING_STRESS;
+            } else if ( reading == READING_PERIODS ) {
+                if ( fieldCount == 3 ) {
+                    result.periods << ( int ) fields[0] << fields[1] << fields[2];
+                }
+            } else if ( fieldCount == 2 ) {
+                if ( reading == READING_ONSET ) {
+                    result.onsetTime.append( fields[0] );
+                    result.onsetValue.append( fields[1] );
+                } else {
+                    result.stressTime.append( fields[0] );
+                    result.stressValue.append( fields[1] );
+                }
+            }
+        }
+
+        line = next;
+    }
+
+    if ( !result.periods.isEmpty() ) {
+        result.duration = result.periods.last();
+    } else if ( !result.stressTime.isEmpty() ) {
+        result.duration = result.stressTime.last();
+    }
+
+    //a legacy file is recognised by its PCM marker and the mean line after it; the onsets can be
+    //missing, the old writer wrote only positive peaks and a silent track had none
+    return foundMean;
+}
+
+void AnalysisFile::close() {
+    for ( int series = 0 ; series < SERIES_COUNT ; series++ ) {
+        for ( QMap<int, LoadedBlock>::iterator it = loadedBlocks[series].begin() ; it != loadedBlocks[series].end() ; ++it ) {
+            this->unloadBlock( it.value() );
+        }
+        loadedBlocks[series].clear();
+        blocks[series].clear();
+    }
+
+    if ( file.isOpen() ) {
+        file.close();
+    }
+
+    buffer.clear();
+    periods.clear();
+    meanAll = 0.0;
+    duration = 0.0;
+    blockDuration = 0.0;
+    optionsFingerprint = 0;
+    opened = false;
+}
+
+bool AnalysisFile::isOpen() const {
+    return opened;
+}
+
+float AnalysisFile::getMeanAll() const {
+    return meanAll;
+}
+
+float AnalysisFile::getDuration() const {
+    return duration;
+}
+
+quint32 AnalysisFile::getOptionsFingerprint() const {
+    return optionsFingerprint;
+}
+
+const QVector<float> &AnalysisFile::getPeriods() const {
+    return periods;
+}
+
+bool AnalysisFile::getSeriesRange( SERIES_ID series, float *firstKey, float *lastKey, float *minValue, float *maxValue ) const {
+    bool found = false;
+    const QVector<BlockEntry> &entries = blocks[series];
+    for ( int i = 0 ; i < entries.size() ; i++ ) {
+        const BlockEntry &entry = entries.at( i );
+        if ( entry.count == 0 ) {
+            continue;
+        }
+
+        if ( !found ) {
+            *firstKey = entry.firstKey;
+            *minValue = entry.minValue;
+            *maxValue = entry.maxValue;
+            found = true;
+        }
+        *lastKey = entry.lastKey;
+        *minValue = qMin( *minValue, entry.minValue );
+        *maxValue = qMax( *maxValue, entry.maxValue );
+    }
+
+    return found;
+}
+
+bool AnalysisFile::fetchRange( double from, double to ) {
+    if ( !opened || blockDuration <= 0.0 ) {
+        return false;
+    }
+
+    //prefetch one visible width on both sides, so panning doesn't hit unfetched blocks
+    double margin = qMax( to - from, ( double ) blockDuration );
+    int blockCount = blocks[SERIES_ONSET].size();
+    int first = qMax( 0, ( int ) qFloor( ( from - margin ) / blockDuration ) );
+    int last = qMin( blockCount - 1, ( int ) qFloor( ( to + margin ) / blockDuration ) );
+
+    bool changed = false;
+    for ( int series = 0 ; series < SERIES_COUNT ; series++ ) {
+        QMap<int, LoadedBlock>::iterator it = loadedBlocks[series].begin();
+        while ( it != loadedBlocks[series].end() ) {
+            if ( it.key() < first || it.key() > last ) {
+                this->unloadBlock( it.value() );
+                it = loadedBlocks[series].erase( it );
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+
+        for ( int i = first ; i <= last ; i++ ) {
+            if ( !loadedBlocks[series].contains( i ) && this->loadBlock( ( SERIES_ID ) series, i ) ) {
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
+
+QVector<SeriesView> AnalysisFile::getSeries( SERIES_ID series ) const {
+    QVector<SeriesView> views;
+    for ( QMap<int, LoadedBlock>::const_iterator it = loadedBlocks[series].constBegin() ; it != loadedBlocks[series].constEnd() ; ++it ) {
+        views.append( it.value().view );
+    }
+
+    return views;
+}
+
+bool AnalysisFile::write( const QString &analysisFilePath, const AnalysisResult &result ) {
+    QByteArray buffer = serialize( result );
+
+    //the whole file goes out in one write to a temporary file, which replaces
+    //the old one only after it's synced, an interrupted write never looks like a result
+    QSaveFile analysisFile( analysisFilePath );
+    if ( !analysisFile.open( QIODevice::WriteOnly ) ) {
+        return false;
+    }
+
+    if ( analysisFile.write( buffer ) != buffer.size() ) {
+        analysisFile.cancelWriting();
+        return false;
+    }
+
+    return analysisFile.commit();
+}
+
+//the same bytes to a device which can't be replaced afterwards, like a pipe
+bool AnalysisFile::write( QIODevice *device, const AnalysisResult &result ) {
+    QByteArray buffer = serialize( result );
+    return device->write( buffer ) == buffer.size();
+}
+
+int AnalysisFile::parseLegacyFields( const char *begin, const char *end, double *fields, int maxFields ) {
+    int fieldCount = 0;
+    const char *p = begin;
+    while ( p < end ) {
+        while ( p < end && ( *p == ' ' || *p == '\t' ) ) {
+            p++;
+        }
+        if ( p == end ) {
+            break;
+        }
+        if ( fieldCount == maxFields ) {
+            return -1;
+        }
+
+        std::from_chars_result parsed = std::from_chars( p, end, fields[fieldCount] );
+        if ( parsed.ec != std::errc() ) {
+            return -1;
+        }
+        fieldCount++;
+
+        p = parsed.ptr;
+        while ( p < end && ( *p == ' ' || *p == '\t' ) ) {
+            p++;
+        }
+        if ( p < end && *p++ != ',' ) {
+            return -1;
+        }
+    }
+
+    return fieldCount;
+}
+
+bool AnalysisFile::parse() {
+    QByteArray header = this->readBytes( 0, HEADER_SIZE );
+    if ( header.size() != HEADER_SIZE ) {
+        return false;
+    }
+
+    const uchar *data = ( const uchar * ) header.constData();
+    if ( memcmp( data, "ONAF", 4 ) != 0 || qFromLittleEndian<quint16>( data + 4 ) != VERSION ) {
+        return false;
+    }
+
+    int sectionCount = qFromLittleEndian<quint16>( data + 6 );
+    QByteArray table = this->readBytes( HEADER_SIZE, sectionCount * SECTION_ENTRY_SIZE );
+    if ( table.size() != sectionCount * SECTION_ENTRY_SIZE ) {
+        return false;
+    }
+
+    qint64 fileSize = buffer.isEmpty() ? file.size() : buffer.size();
+
+    for ( int i = 0 ; i < sectionCount ; i++ ) {
+        const uchar *entry = ( const uchar * ) table.constData() + i * SECTION_ENTRY_SIZE;
+        quint32 id = qFromLittleEndian<quint32>( entry );
+        quint32 count = qFromLittleEndian<quint32>( entry + 4 );
+        quint64 offset = qFromLittleEndian<quint64>( entry + 8 );
+        quint64 size = qFromLittleEndian<quint64>( entry + 16 );
+
+        QByteArray section = this->readBytes( offset, size );
+        if ( ( quint64 ) section.size() != size ) {
+            return false;
+        }
+        const uchar *values = ( const uchar * ) section.constData();
+
+        switch ( id ) {
+            case SECTION_INFO:
+                if ( count < 3 || size < count * sizeof( float ) ) {
+                    return false;
+                }
+                meanAll = readFloat( values );
+                duration = readFloat( values + 4 );
+                blockDuration = readFloat( values + 8 );
+                optionsFingerprint = count >= 4 ? qFromLittleEndian<quint32>( values + 12 ) : 0;
+                break;
+
+            case SECTION_PERIODS:
+                if ( size < count * sizeof( float ) ) {
+                    return false;
+                }
+                periods.resize( count );
+                for ( quint32 j = 0 ; j < count ; j++ ) {
+                    periods[j] = readFloat( values + j * 4 );
+                }
+                break;
+
+            case SECTION_ONSET_INDEX:
+            case SECTION_STRESS_INDEX: {
+                if ( size < ( quint64 ) count * BLOCK_ENTRY_SIZE ) {
+                    return false;
+                }
+
+                QVector<BlockEntry> &entries = blocks[id == SECTION_ONSET_INDEX ? SERIES_ONSET : SERIES_STRESS];
+                entries.resize( count );
+                for ( quint32 j = 0 ; j < count ; j++ ) {
+                    const uchar *blockEntry = values + j * BLOCK_ENTRY_SIZE;
+                    BlockEntry &block = entries[j];
+                    block.offset = qFromLittleEndian<quint64>( blockEntry );
+                    block.size = qFromLittleEndian<quint32>( blockEntry + 8 );
+                    block.count = qFromLittleEndian<quint32>( blockEntry + 12 );
+                    block.encoding = qFromLittleEndian<quint32>( blockEntry + 16 );
+                    block.firstKey = readFloat( blockEntry + 20 );
+                    block.lastKey = readFloat( blockEntry + 24 );
+                    block.minValue = readFloat( blockEntry + 28 );
+                    block.maxValue = readFloat( blockEntry + 32 );
+
+                    bool validLayout;
+                    if ( block.encoding == ENCODING_FLOAT32 ) {
+                        validLayout = block.size == block.count * 2 * sizeof( float ) && block.offset % sizeof( float ) == 0;
+                    } else {
+                        validLayout = block.encoding == ENCODING_UNIFORM || block.encoding == ENCODING_FRAMES;
+                    }
+
+                    if ( !validLayout || block.offset + block.size > ( quint64 ) fileSize ) {
+                        return false;
+                    }
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    return blockDuration > 0.0 && blocks[SERIES_ONSET].size() == blocks[SERIES_STRESS].size();
+}
+
+QByteArray AnalysisFile::readBytes( qint64 offset, qint64 size ) {
+    if ( !buffer.isEmpty() ) {
+        if ( offset < 0 || offset + size > buffer.size() ) {
+            return QByteArray();
+        }
+        return buffer.mid( offset, size );
+    }
+
+    if ( offset < 0 || offset + size > file.size() || !file.seek( offset ) ) {
+        return QByteArray();
+    }
+
+    return file.read( size );
+}
+
+bool AnalysisFile::loadBlock( SERIES_ID series, int index ) {
+    const BlockEntry &entry = blocks[series].at( index );
+    if ( entry.count == 0 ) {
+        return false;
+    }
+
+    if ( entry.encoding != ENCODING_FLOAT32 ) {
+        //compressed blocks are small, read and decode them instead of mapping
+        QByteArray payload = this->readBytes( entry.offset, entry.size );
+        LoadedBlock block;
+        block.mapping = 0;
+        if ( payload.size() != ( int ) entry.size || !decodeBlock( entry, ( const uchar * ) payload.constData(), block ) ) {
+            return false;
+        }
+
+        LoadedBlock &loaded = loadedBlocks[series][index];
+        loaded = block;
+        loaded.view.keys = loaded.keys.constData();
+        loaded.view.values = loaded.values.constData();
+        loaded.view.count = entry.count;
+        return true;
+    }
+
+    const uchar *payload;
+    uchar *mapping = 0;
+    if ( !buffer.isEmpty() ) {
+        payload = ( const uchar * ) buffer.constData() + entry.offset;
+    } else {
+        mapping = file.map( entry.offset, entry.size );
+        if ( !mapping ) {
+            return false;
+        }
+        payload = mapping;
+    }
+
+    LoadedBlock &block = loadedBlocks[series][index];
+    block.mapping = mapping;
+    block.view.count = entry.count;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    block.view.keys = ( const float * ) payload;
+    block.view.values = block.view.keys + entry.count;
+#else
+    block.keys.resize( entry.count );
+    block.values.resize( entry.count );
+    for ( quint32 i = 0 ; i < entry.count ; i++ ) {
+        block.keys[i] = readFloat( payload + i * 4 );
+        block.values[i] = readFloat( payload + ( entry.count + i ) * 4 );
+    }
+    block.view.keys = block.keys.constData();
+    block.view.values = block.values.constData();
+#endif
+
+    return true;
+}
+
+bool AnalysisFile::decodeBlock( const BlockEntry &entry, const uchar *payload, LoadedBlock &block ) {
+    const uchar *data = payload;
+    const uchar *end = payload + entry.size;
+    int headerSize = entry.encoding == ENCODING_UNIFORM ? 20 : 12;
+    if ( end - data < headerSize ) {
+        return false;
+    }
+
+    //every value takes at least a byte and so does every sparse key,
+    //a count the payload can't hold is rejected before anything is allocated for it
+    quint64 minimumSize = ( quint64 ) entry.count * ( entry.encoding == ENCODING_UNIFORM ? 1 : 2 );
+    if ( minimumSize > ( quint64 ) ( end - data - headerSize ) ) {
+        return false;
+    }
+    int count = entry.count;
+
+    block.keys.resize( count );
+    block.values.resize( count );
+
+    float quantum;
+    if ( entry.encoding == ENCODING_UNIFORM ) {
+        double t0 = readDouble( data );
+        double dt = readDouble( data + 8 );
+        quantum = readFloat( data + 16 );
+        data += 20;
+
+        for ( int i = 0 ; i < count ; i++ ) {
+            block.keys[i] = t0 + i * dt;
+        }
+    } else {
+        double frameDuration = readDouble( data );
+        quantum = readFloat( data + 8 );
+        data += 12;
+
+        quint64 frame = 0;
+        for ( int i = 0 ; i < count ; i++ ) {
+            quint64 delta;
+            if ( !readVarint( data, end, delta ) ) {
+                return false;
+            }
+            frame += delta;
+            block.keys[i] = frame * frameDuration;
+        }
+    }
+
+    qint64 level = 0;
+    for ( int i = 0 ; i < count ; i++ ) {
+        quint64 delta;
+        if ( !readVarint( data, end, delta ) ) {
+            return false;
+        }
+        level += unzigzag( delta );
+        block.values[i] = ( double ) level * quantum;
+    }
+
+    return true;
+}
+
+QByteArray AnalysisFile::encodeBlock( const float *keys, const float *values, int count, double step, bool sparse ) {
+    QByteArray payload;
+    if ( count <= 0 || step <= 0.0 ) {
+        return payload;
+    }
+
+    //keys have to sit on the step grid, otherwise the block stays float32
+    qint64 firstIndex = qRound64( keys[0] / step );
+    QVector<quint64> indices( count );
+    for ( int i = 0 ; i < count ; i++ ) {
+        qint64 index = qRound64( keys[i] / step );
+        if ( qAbs( keys[i] - index * step ) > KEY_TOLERANCE * step || index < 0 ||
+                ( i > 0 && index <= ( qint64 ) indices[i - 1] ) || ( !sparse && index != firstIndex + i ) ) {
+            return QByteArray();
+        }
+        indices[i] = index;
+    }
+
+    if ( sparse ) {
+        appendDouble( step, payload );
+        appendFloat( VALUE_QUANTUM, payload );
+
+        quint64 frame = 0;
+        for ( int i = 0 ; i < count ; i++ ) {
+            appendVarint( indices[i] - frame, payload );
+            frame = indices[i];
+        }
+    } else {
+        appendDouble( firstIndex * step, payload );
+        appendDouble( step, payload );
+        appendFloat( VALUE_QUANTUM, payload );
+    }
+
+    qint64 level = 0;
+    for ( int i = 0 ; i < count ; i++ ) {
+        qint64 quantised = qRound64( values[i] / VALUE_QUANTUM );
+        appendVarint( zigzag( quantised - level ), payload );
+        level = quantised;
+    }
+
+    return payload;
+}
+
+void AnalysisFile::unloadBlock( LoadedBlock &block ) {
+    if ( block.mapping ) {
+        file.unmap( block.mapping );
+        block.mapping = 0;
+    }
+}
+
+QByteArray AnalysisFile::serialize( const AnalysisResult &result ) {
+    const QVector<float> *keys[SERIES_COUNT] = { &result.onsetTime, &result.stressTime };
+    const QVector<float> *values[SERIES_COUNT] = { &result.onsetValue, &result.stressValue };
+    const double steps[SERIES_COUNT] = { result.onsetFrameDuration, result.stressStep };
+
+    float end = result.duration;
+    for ( int series = 0 ; series < SERIES_COUNT ; series++ ) {
+        if ( !keys[series]->isEmpty() ) {
+            end = qMax( end, keys[series]->last() );
+        }
+    }
+    int blockCount = ( int ) qFloor( end / BLOCK_DURATION ) + 1;
+
+    //points of block b are [blockBegin[b], blockBegin[b + 1])
+    QVector<int> blockBegin[SERIES_COUNT];
+    QVector<QByteArray> payloads[SERIES_COUNT];
+    QVector<quint32> encodings[SERIES_COUNT];
+    for ( int series = 0 ; series < SERIES_COUNT ; series++ ) {
+        int count = qMin( keys[series]->size(), values[series]->size() );
+        blockBegin[series].resize( blockCount + 1 );
+
+        int j = 0;
+        for ( int b = 0 ; b < blockCount ; b++ ) {
+            blockBegin[series][b] = j;
+            while ( j < count && ( b == blockCount - 1 || keys[series]->at( j ) < ( b + 1 ) * BLOCK_DURATION ) ) {
+                j++;
+            }
+        }
+        blockBegin[series][blockCount] = count;
+
+        for ( int b = 0 ; b < blockCount ; b++ ) {
+            int begin = blockBegin[series][b];
+            int blockSize = blockBegin[series][b + 1] - begin;
+            const float *blockKeys = keys[series]->constData() + begin;
+            const float *blockValues = values[series]->constData() + begin;
+
+            QByteArray payload = encodeBlock( blockKeys, blockValues, blockSize, steps[series], series == SERIES_ONSET );
+            quint32 encoding = series == SERIES_ONSET ? ENCODING_FRAMES : ENCODING_UNIFORM;
+            if ( payload.isEmpty() ) {
+                encoding = ENCODING_FLOAT32;
+                for ( int i = 0 ; i < blockSize ; i++ ) {
+                    appendFloat( blockKeys[i], payload );
+                }
+                for ( int i = 0 ; i < blockSize ; i++ ) {
+                    appendFloat( blockValues[i], payload );
+                }
+            }
+            payloads[series].append( payload );
+            encodings[series].append( encoding );
+        }
+    }
+
+    const int sectionCount = 4;
+    qint64 offset = HEADER_SIZE + sectionCount * SECTION_ENTRY_SIZE;
+
+    offset = align( offset, SECTION_ALIGNMENT );
+    qint64 infoOffset = offset;
+    offset += 4 * sizeof( float );
+
+    offset = align( offset, SECTION_ALIGNMENT );
+    qint64 periodsOffset = offset;
+    offset += result.periods.size() * sizeof( float );
+
+    qint64 indexOffset[SERIES_COUNT];
+    for ( int series = 0 ; series < SERIES_COUNT ; series++ ) {
+        offset = align( offset, SECTION_ALIGNMENT );
+        indexOffset[series] = offset;
+        offset += blockCount * BLOCK_ENTRY_SIZE;
+    }
+
+    //blocks of the same time range are stored next to each other,
+    //only float32 blocks are mapped so only they need alignment
+    QVector<qint64> payloadOffset[SERIES_COUNT];
+    for ( int b = 0 ; b < blockCount ; b++ ) {
+        for ( int series = 0 ; series < SERIES_COUNT ; series++ ) {
+            if ( encodings[series].at( b ) == ENCODING_FLOAT32 ) {
+                offset = align( offset, SECTION_ALIGNMENT );
+            }
+            payloadOffset[series].append( offset );
+            offset += payloads[series].at( b ).size();
+        }
+    }
+
+    QByteArray buffer( ( int ) offset, 0 );
+    uchar *out = ( uchar * ) buffer.data();
+
+    memcpy( out, "ONAF", 4 );
+    qToLittleEndian<quint16>( VERSION, out + 4 );
+    qToLittleEndian<quint16>( sectionCount, out + 6 );
+
+    quint32 sectionIds[sectionCount] = { SECTION_INFO, SECTION_PERIODS, SECTION_ONSET_INDEX, SECTION_STRESS_INDEX };
+    quint32 sectionCounts[sectionCount] = { 4, ( quint32 ) result.periods.size(), ( quint32 ) blockCount, ( quint32 ) blockCount };
+    qint64 sectionOffsets[sectionCount] = { infoOffset, periodsOffset, indexOffset[SERIES_ONSET], indexOffset[SERIES_STRESS] };
+    qint64 sectionSizes[sectionCount] = { 4 * sizeof( float ), ( qint64 ) ( result.periods.size() * sizeof( float ) ),
+                                          blockCount * BLOCK_ENTRY_SIZE, blockCount * BLOCK_ENTRY_SIZE
+                                        };
+    for ( int i = 0 ; i < sectionCount ; i++ ) {
+        uchar *entry = out + HEADER_SIZE + i * SECTION_ENTRY_SIZE;
+        qToLittleEndian<quint32>( sectionIds[i], entry );
+        qToLittleEndian<quint32>( sectionCounts[i], entry + 4 );
+        qToLittleEndian<quint64>( sectionOffsets[i], entry + 8 );
+        qToLittleEndian<quint64>( sectionSizes[i], entry + 16 );
+    }
+
+    writeFloat( result.meanAll, out + infoOffset );
+    writeFloat( result.duration, out + infoOffset + 4 );
+    writeFloat( BLOCK_DURATION, out + infoOffset + 8 );
+    qToLittleEndian<quint32>( result.optionsFingerprint, out + infoOffset + 12 );
+
+    for ( int i = 0 ; i < result.periods.size() ; i++ ) {
+        writeFloat( result.periods.at( i ), out + periodsOffset + i * 4 );
+    }
+
+    for ( int series = 0 ; series < SERIES_COUNT ; series++ ) {
+        for ( int b = 0 ; b < blockCount ; b++ ) {
+            int begin = blockBegin[series][b];
+            int count = blockBegin[series][b + 1] - begin;
+            const QByteArray &payload = payloads[series].at( b );
+            memcpy( out + payloadOffset[series].at( b ), payload.constData(), payload.size() );
+
+            float minValue = 0.0;
+            float maxValue = 0.0;
+            for ( int i = 0 ; i < count ; i++ ) {
+                float value = values[series]->at( begin + i );
+                if ( i == 0 || value < minValue ) {
+                    minValue = value;
+                }
+                if ( i == 0 || value > maxValue ) {
+                    maxValue = value;
+                }
+            }
+
+            uchar *entry = out + indexOffset[series] + b * BLOCK_ENTRY_SIZE;
+            qToLittleEndian<quint64>( payloadOffset[series].at( b ), entry );
+            qToLittleEndian<quint32>( payload.size(), entry + 8 );
+            qToLittleEndian<quint32>( count, entry + 12 );
+            qToLittleEndian<quint32>( encodings[series].at( b ), entry + 16 );
+            writeFloat( count > 0 ? keys[series]->at( begin ) : 0.0, entry + 20 );
+            writeFloat( count > 0 ? keys[series]->at( begin + count - 1 ) : 0.0, entry + 24 );
+            writeFloat( minValue, entry + 28 );
+            writeFloat( maxValue, entry + 32 );
+        }
+    }
+
+    return buffer;
+}
@@ -0,0 +1,134 @@
+#ifndef ANALYSISFILE_H
+#define ANALYSISFILE_H
+
+#include <QFile>
+#include <QMap>
+#include <QVector>
+#include <QtEndian>
+
+//non-owning view of a key/value series, valid while its block stays fetched
+struct                                  SeriesView {
+    const float                         *keys;
+    const float                         *values;
+    int                                 count;
+
+    SeriesView() :
+        keys( 0 ), values( 0 ), count( 0 ) {}
+};
+
+struct                                  AnalysisResult {
+    float                               meanAll;
+    float                               duration;
+    double                              onsetFrameDuration;        //onset keys are multiples of it, 0 if unknown
+    double                              stressStep;        //stress keys are evenly spaced by it, 0 if unknown
+    QVector<float>                      onsetTime;
+    QVector<float>                      onsetValue;
+    QVector<float>                      stressTime;
+    QVector<float>                      stressValue;
+    QVector<float>                      periods;        //periodType, periodBegin, periodEnd triples
+    quint32                             optionsFingerprint;        //of the analysis options it was produced with, 0 if unknown
+
+    AnalysisResult() :
+        meanAll( 0.0 ), duration( 0.0 ), onsetFrameDuration( 0.0 ), stressStep( 0.0 ), optionsFingerprint( 0 ) {}
+};
+
+//binary audio info file:
+//header, section table, small sections read on open, then series split into
+//fixed-duration blocks which are mapped only while they're near the visible range
+class AnalysisFile {
+
+public:
+    enum                                SERIES_ID {
+        SERIES_ONSET = 0,
+        SERIES_STRESS = 1,
+        SERIES_COUNT = 2
+    };
+
+                                        AnalysisFile();
+                                        ~AnalysisFile();
+
+    bool                                open( const QString &analysisFilePath );
+    bool                                openLegacy( const QString &audioInfoFilePath );
+    void                                close();
+    bool                                isOpen() const;
+
+    float                               getMeanAll() const;
+    float                               getDuration() const;
+    quint32                             getOptionsFingerprint() const;
+    const QVector<float>                &getPeriods() const;
+    bool                                getSeriesRange( SERIES_ID series, float *firstKey, float *lastKey, float *minValue, float *maxValue ) const;
+
+    bool                                fetchRange( double from, double to );
+    QVector<SeriesView>                 getSeries( SERIES_ID series ) const;
+
+    static bool                         write( const QString &analysisFilePath, const AnalysisResult &result );
+    static bool                         write( QIODevice *device, const AnalysisResult &result );
+    static bool                         parseLegacy( const char *text, qint64 size, AnalysisResult &result );
+
+    static const quint16                VERSION = 3;
+
+private:
+    enum                                SECTION_ID {
+        SECTION_INFO = 1,               //meanAll, duration, blockDuration, then the options fingerprint as uint32 if present
+        SECTION_PERIODS = 2,
+        SECTION_ONSET_INDEX = 3,
+        SECTION_STRESS_INDEX = 4
+    };
+
+    enum                                ENCODING {
+        ENCODING_FLOAT32 = 0,           //keys then values, little-endian float32
+        ENCODING_UNIFORM = 1,           //t0, dt, quantum, then zigzag varint deltas of quantised values
+        ENCODING_FRAMES = 2             //frame duration, quantum, varint frame index deltas, then values as above
+    };
+
+    struct                              BlockEntry {
+        quint64                         offset;
+        quint32                         size;
+        quint32                         count;
+        quint32                         encoding;
+        float                           firstKey;
+        float                           lastKey;
+        float                           minValue;
+        float                           maxValue;
+    };
+
+    struct                              LoadedBlock {
+        uchar                           *mapping;
+        QVector<float>                  keys;
+        QVector<float>                  values;
+        SeriesView                      view;
+    };
+
+    static const int                    HEADER_SIZE = 16;
+    static const int                    SECTION_ENTRY_SIZE = 24;
+    static const int                    BLOCK_ENTRY_SIZE = 40;
+    static const int                    SECTION_ALIGNMENT = 16;
+    static const int                    BLOCK_DURATION = 60;
+    static const float                  VALUE_QUANTUM;
+    static const double                 KEY_TOLERANCE;
+
+    QFile                               file;
+    QByteArray                          buffer;
+    bool                                opened;
+
+    float                               meanAll;
+    float                               duration;
+    float                               blockDuration;
+    quint32                             optionsFingerprint;
+    QVector<float>                      periods;
+    QVector<BlockEntry>                 blocks[SERIES_COUNT];
+    QMap<int, LoadedBlock>              loadedBlocks[SERIES_COUNT];
+
+    bool                                parse();
+    static int                          parseLegacyFields( const char *begin, const char *end, double *fields, int maxFields );
+    QByteArray                          readBytes( qint64 offset, qint64 size );
+    bool                                loadBlock( SERIES_ID series, int index );
+    void                                unloadBlock( LoadedBlock &block );
+
+    static bool                         decodeBlock( const BlockEntry &entry, const uchar *payload, LoadedBlock &block );
+    static QByteArray                   encodeBlock( const float *keys, const float *values, int count, double step, bool sparse );
+
+    static QByteArray                   serialize( const AnalysisResult &result );
+};
+
+#endif // ANALYSISFILE_H
@@ -0,0 +1,196 @@
+#include "analysismigration.h"
+#include <QDebug>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+class MigrationJob : public QRunnable {
+
+public:
+                                        MigrationJob( AnalysisMigration *migration, const QString &legacyFilePath, QSemaphore *queueSlots ) :
+        migration( migration ), legacyFilePath( legacyFilePath ), queueSlots( queueSlots ) {}
+
+    void                                run() {
+        migration->migrateFile( legacyFilePath );
+        queueSlots->release();
+    }
+
+private:
+    AnalysisMigration                   *migration;
+    QString                             legacyFilePath;
+    QSemaphore                          *queueSlots;
+};
+
+AnalysisMigration::AnalysisMigration() :
+    threadCount( QThread::idealThreadCount() ),
+    ioConcurrency( 4 ),
+    verbose( false ),
+    ioSlots( 0 ) {
+}
+
+void AnalysisMigration::setThreadCount( int threadCount ) {
+    this->threadCount = qMax( 1, threadCount );
+}
+
+void AnalysisMigration::setIoConcurrency( int ioConcurrency ) {
+    this->ioConcurrency = qMax( 1, ioConcurrency );
+}
+
+void AnalysisMigration::setVerbose( bool verbose ) {
+    this->verbose = verbose;
+}
+
+bool AnalysisMigration::migrate( const QString &directoryPath ) {
+    if ( !QFileInfo( directoryPath ).isDir() ) {
+        qWarning() << "not a directory:" << directoryPath;
+        return false;
+    }
+
+    convertedCount = 0;
+    skippedCount = 0;
+    failedCount = 0;
+
+    //parsing runs on every thread, file reads and writes share fewer slots
+    //so a slow disk isn't hit by all threads at once
+    QSemaphore io( ioConcurrency );
+    ioSlots = &io;
+
+    //bounded job queue, a directory of a million entries isn't queued at once
+    QSemaphore queueSlots( threadCount * 4 );
+
+    QThreadPool pool;
+    pool.setMaxThreadCount( threadCount );
+
+    QDirIterator it( directoryPath, QStringList() << "*.txt", QDir::Files );
+    while ( it.hasNext() ) {
+        QString legacyFilePath = it.next();
+        queueSlots.acquire();
+        pool.start( new MigrationJob( this, legacyFilePath, &queueSlots ) );
+    }
+
+    pool.waitForDone();
+    ioSlots = 0;
+
+    return failedCount.load() == 0;
+}
+
+int AnalysisMigration::getConvertedCount() const {
+    return convertedCount.load();
+}
+
+int AnalysisMigration::getSkippedCount() const {
+    return skippedCount.load();
+}
+
+int AnalysisMigration::getFailedCount() const {
+    return failedCount.load();
+}
+
+void AnalysisMigration::migrateFile( const QString &legacyFilePath ) {
+    QFileInfo legacyFileInfo( legacyFilePath );
+    QString analysisFilePath = legacyFileInfo.absolutePath() + "/" + legacyFileInfo.completeBaseName() + ".onset";
+
+    MIGRATION_RESULT result = this->convert( legacyFilePath, analysisFilePath );
+    switch ( result ) {
+        case MIGRATION_CONVERTED:
+            convertedCount.ref();
+            if ( verbose ) {
+                qInfo() << "converted" << legacyFilePath;
+            }
+            break;
+
+        case MIGRATION_SKIPPED:
+            skippedCount.ref();
+            break;
+
+        case MIGRATION_FAILED:
+            failedCount.ref();
+            qWarning() << "failed to migrate" << legacyFilePath;
+            break;
+    }
+}
+
+AnalysisMigration::MIGRATION_RESULT AnalysisMigration::convert( const QString &legacyFilePath, const QString &analysisFilePath ) {
+    //an existing file which opens was converted by an earlier run,
+    //anything else, like one of an older format version, is converted again
+    ioSlots->acquire();
+    AnalysisFile existing;
+    bool converted = QFile::exists( analysisFilePath ) && existing.open( analysisFilePath );
+    existing.close();
+
+    QByteArray text;
+    if ( !converted ) {
+        QFile legacyFile( legacyFilePath );
+        if ( legacyFile.open( QIODevice::ReadOnly ) ) {
+            text = legacyFile.readAll();
+        }
+    }
+    ioSlots->release();
+
+    if ( converted ) {
+        return MIGRATION_SKIPPED;
+    }
+
+    AnalysisResult result;
+    if ( text.isEmpty() || !AnalysisFile::parseLegacy( text.constData(), text.size(), result ) ) {
+        return MIGRATION_FAILED;
+    }
+    text.clear();
+
+    ioSlots->acquire();
+    bool written = AnalysisFile::write( analysisFilePath, result ) && this->verify( analysisFilePath, result );
+    if ( !written ) {
+        QFile::remove( analysisFilePath );
+    }
+    ioSlots->release();
+
+    return written ? MIGRATION_CONVERTED : MIGRATION_FAILED;
+}
+
+bool AnalysisMigration::verify( const QString &analysisFilePath, const AnalysisResult &result ) {
+    AnalysisFile analysisFile;
+    if ( !analysisFile.open( analysisFilePath ) ) {
+        return false;
+    }
+
+    if ( analysisFile.getMeanAll() != result.meanAll || analysisFile.getDuration() != result.duration ||
+            analysisFile.getPeriods() != result.periods ) {
+        return false;
+    }
+
+    //legacy series have no sample grid, they're stored as float32 and must come back bit for bit
+    const QVector<float> *keys[AnalysisFile::SERIES_COUNT] = { &result.onsetTime, &result.stressTime };
+    const QVector<float> *values[AnalysisFile::SERIES_COUNT] = { &result.onsetValue, &result.stressValue };
+
+    float end = result.duration;
+    for ( int series = 0 ; series < AnalysisFile::SERIES_COUNT ; series++ ) {
+        if ( !keys[series]->isEmpty() ) {
+            end = qMax( end, keys[series]->last() );
+        }
+    }
+    analysisFile.fetchRange( 0.0, end );
+
+    for ( int series = 0 ; series < AnalysisFile::SERIES_COUNT ; series++ ) {
+        QVector<SeriesView> views = analysisFile.getSeries( ( AnalysisFile::SERIES_ID ) series );
+        int n = 0;
+        for ( int v = 0 ; v < views.size() ; v++ ) {
+            const SeriesView &view = views.at( v );
+            if ( n + view.count > keys[series]->size() ) {
+                return false;
+            }
+            for ( int i = 0 ; i < view.count ; i++, n++ ) {
+                if ( view.keys[i] != keys[series]->at( n ) || view.values[i] != values[series]->at( n ) ) {
+                    return false;
+                }
+            }
+        }
+
+        if ( n != keys[series]->size() ) {
+            return false;
+        }
+    }
+
+    return true;
+}
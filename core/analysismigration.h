@@ -0,0 +1,49 @@
+#ifndef ANALYSISMIGRATION_H
+#define ANALYSISMIGRATION_H
+
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QString>
+#include "analysisfile.h"
+
+//converts legacy <sha1>.txt audio info files of a directory into <sha1>.onset,
+//entries which already have a valid .onset are skipped, so an interrupted run resumes
+class AnalysisMigration {
+
+public:
+                                        AnalysisMigration();
+
+    void                                setThreadCount( int threadCount );
+    void                                setIoConcurrency( int ioConcurrency );
+    void                                setVerbose( bool verbose );
+
+    bool                                migrate( const QString &directoryPath );
+
+    int                                 getConvertedCount() const;
+    int                                 getSkippedCount() const;
+    int                                 getFailedCount() const;
+
+private:
+    enum                                MIGRATION_RESULT {
+        MIGRATION_CONVERTED,
+        MIGRATION_SKIPPED,
+        MIGRATION_FAILED
+    };
+
+    int                                 threadCount;
+    int                                 ioConcurrency;
+    bool                                verbose;
+
+    QSemaphore                          *ioSlots;
+    QAtomicInt                          convertedCount;
+    QAtomicInt                          skippedCount;
+    QAtomicInt                          failedCount;
+
+    void                                migrateFile( const QString &legacyFilePath );
+    MIGRATION_RESULT                    convert( const QString &legacyFilePath, const QString &analysisFilePath );
+    bool                                verify( const QString &analysisFilePath, const AnalysisResult &result );
+
+    friend class                        MigrationJob;
+};
+
+#endif // ANALYSISMIGRATION_H
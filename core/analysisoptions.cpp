@@ -0,0 +1,65 @@
+#include "analysisoptions.h"
+#include "analysisbatch.h"
+#include "onlineonsetdetector.h"
+#include <QDebug>
+
+//the ranges are the ones of the window's spin boxes
+void AnalysisOptions::addTo( QCommandLineParser &parser ) {
+    parser.addOption( QCommandLineOption( "threshold-window", "Onset threshold window, in frames (1 - 2048).", "frames", "20" ) );
+    parser.addOption( QCommandLineOption( "multiplier", "Onset threshold multiplier (1.0 - 2.0).", "value", "1.5" ) );
+    parser.addOption( QCommandLineOption( "peak-pre", "Frames before a peak it has to be the maximum of (0 - 64).", "frames", "0" ) );
+    parser.addOption( QCommandLineOption( "peak-post", "Frames after a peak it has to be the maximum of (0 - 64).", "frames", "1" ) );
+    parser.addOption( QCommandLineOption( "peak-min-interval", "Frames between two onsets at least (0 - 256).", "frames", "0" ) );
+    parser.addOption( QCommandLineOption( "no-window", "Don't apply a window to the FFT frames." ) );
+    parser.addOption( QCommandLineOption( "superflux", "Detect onsets on SuperFlux instead of spectral flux." ) );
+    parser.addOption( QCommandLineOption( "multi-resolution", "Fuse onset detection over several frame sizes." ) );
+    parser.addOption( QCommandLineOption( "waveform-step", "Keep every <step>-th sample for the stress curve (1 - 2048).", "step", "512" ) );
+    parser.addOption( QCommandLineOption( "stress-window", "Stress RMS window, in kept samples (1 - 8192).", "samples", "256" ) );
+}
+
+bool AnalysisOptions::read( const QCommandLineParser &parser ) {
+    thresholdWindowSize = parser.value( "threshold-window" ).toInt();
+    multiplier = parser.value( "multiplier" ).toDouble();
+    window = !parser.isSet( "no-window" );
+    peakPreWindow = parser.value( "peak-pre" ).toInt();
+    peakPostWindow = parser.value( "peak-post" ).toInt();
+    peakMinInterval = parser.value( "peak-min-interval" ).toInt();
+    detectionFunction = parser.isSet( "superflux" ) ? AudioAnalysis::DETECTION_FUNCTION_SUPERFLUX : AudioAnalysis::DETECTION_FUNCTION_FLUX;
+    multiResolution = parser.isSet( "multi-resolution" );
+    pcmStep = parser.value( "waveform-step" ).toInt();
+    stressWindow = parser.value( "stress-window" ).toInt();
+
+    if ( thresholdWindowSize < 1 || thresholdWindowSize > 2048 || multiplier < 1.0 || multiplier > 2.0 ||
+            pcmStep < 1 || pcmStep > 2048 || stressWindow < 1 || stressWindow > 8192 ||
+            peakPreWindow < 0 || peakPreWindow > AudioAnalysis::MAX_PEAK_WINDOW ||
+            peakPostWindow < 0 || peakPostWindow > AudioAnalysis::MAX_PEAK_WINDOW ||
+            peakMinInterval < 0 || peakMinInterval > AudioAnalysis::MAX_PEAK_MIN_INTERVAL ) {
+        qWarning() << "analysis option out of range";
+        return false;
+    }
+
+    return true;
+}
+
+//pcmStep and stressWindow are arguments of AudioAnalysis::analyse()
+void AnalysisOptions::applyTo( AudioAnalysis &analysis ) const {
+    analysis.setOnsetOptions( thresholdWindowSize, multiplier, window );
+    analysis.setPeakOptions( peakPreWindow, peakPostWindow, peakMinInterval );
+    analysis.setDetectionFunction( detectionFunction );
+    analysis.setMultiResolution( multiResolution );
+}
+
+//the window is an argument of its constructor, multiResolution isn't detected live
+void AnalysisOptions::applyTo( OnlineOnsetDetector &detector ) const {
+    detector.setOnsetOptions( thresholdWindowSize, multiplier );
+    detector.setPeakOptions( peakPreWindow, peakPostWindow, peakMinInterval );
+    detector.setDetectionFunction( detectionFunction );
+}
+
+void AnalysisOptions::applyTo( AnalysisBatch &batch ) const {
+    batch.setAnalysisOptions( pcmStep, stressWindow );
+    batch.setOnsetOptions( thresholdWindowSize, multiplier, window );
+    batch.setPeakOptions( peakPreWindow, peakPostWindow, peakMinInterval );
+    batch.setDetectionFunction( detectionFunction );
+    batch.setMultiResolution( multiResolution );
+}
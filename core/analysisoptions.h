@@ -0,0 +1,38 @@
+#ifndef ANALYSISOPTIONS_H
+#define ANALYSISOPTIONS_H
+
+#include <QCommandLineParser>
+#include "audioanalysis.h"
+
+class AnalysisBatch;
+class OnlineOnsetDetector;
+
+//analysis options of the command lines, onset-cli and Onset --batch define and check them here
+struct                                  AnalysisOptions {
+    int                                 thresholdWindowSize;
+    double                              multiplier;
+    bool                                window;
+    int                                 peakPreWindow;
+    int                                 peakPostWindow;
+    int                                 peakMinInterval;
+    AudioAnalysis::DETECTION_FUNCTION   detectionFunction;
+    bool                                multiResolution;
+    int                                 pcmStep;
+    int                                 stressWindow;
+
+    AnalysisOptions() :
+        thresholdWindowSize( 20 ), multiplier( 1.5 ), window( true ),
+        peakPreWindow( 0 ), peakPostWindow( 1 ), peakMinInterval( 0 ),
+        detectionFunction( AudioAnalysis::DETECTION_FUNCTION_FLUX ), multiResolution( false ),
+        pcmStep( 512 ), stressWindow( 256 ) {}
+
+    static void                         addTo( QCommandLineParser &parser );
+    //false with a warning if one of them is out of range
+    bool                                read( const QCommandLineParser &parser );
+
+    void                                applyTo( AudioAnalysis &analysis ) const;
+    void                                applyTo( OnlineOnsetDetector &detector ) const;
+    void                                applyTo( AnalysisBatch &batch ) const;
+};
+
+#endif // ANALYSISOPTIONS_H
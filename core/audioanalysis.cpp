@@ -0,0 +1,611 @@
+#include "audioanalysis.h"
+#include "decodechannelsource.h"
+#include "spscring.h"
+#include <QSemaphore>
+#include <QThread>
+#include <climits>
+
+struct DecodedPiece {
+    QVector<float>                      samples;
+    int                                 sampleCount;        //interleaved, 0 once the stream ended
+};
+
+//decoding stage of extractFeatures(), fills pieces ahead of the analysis until the source ends or it's stopped
+class PieceDecoder : public QThread {
+
+public:
+                                        PieceDecoder( AudioSource *source, SpscRing<DecodedPiece> *pieces ) :
+        source( source ), pieces( pieces ), stopped( 0 ), freePieces( pieces->getCapacity() ), decodedPieces( 0 ) {}
+
+    void                                stop() {
+        stopped.storeRelease( 1 );
+        freePieces.release();
+    }
+
+    //the next decoded piece, 0 if none is ready within timeout ms; the ring stays lock-free,
+    //the semaphores only put either side to sleep while it's full or empty
+    DecodedPiece                        *takePiece( int timeout ) {
+        if ( !decodedPieces.tryAcquire( 1, timeout ) ) {
+            return 0;
+        }
+        return pieces->beginRead();
+    }
+
+    void                                returnPiece() {
+        pieces->endRead();
+        freePieces.release();
+    }
+
+protected:
+    void                                run() {
+        while ( true ) {
+            freePieces.acquire();
+            if ( stopped.loadAcquire() ) {
+                return;
+            }
+
+            DecodedPiece *piece = pieces->beginWrite();
+            int sampleCount = source->read( piece->samples.data(), piece->samples.size() );
+            piece->sampleCount = sampleCount;
+            pieces->endWrite();
+            decodedPieces.release();
+
+            if ( sampleCount == 0 ) {
+                return;
+            }
+        }
+    }
+
+private:
+    AudioSource                         *source;
+    SpscRing<DecodedPiece>              *pieces;
+    QAtomicInt                          stopped;
+    QSemaphore                          freePieces;
+    QSemaphore                          decodedPieces;
+};
+
+AudioAnalysis::AudioAnalysis() :
+    dataDirectoryPath( "D:\\audios" ),
+    frequency( 0 ), channels( 0 ), duration( 0.0 ), source( 0 ), observer( 0 ),
+    ONSET_THRESHOLD_WINDOW_SIZE( 20 ), ONSET_MULTIPLIER( 1.5 ), ONSET_WINDOW( 0 ),
+    ONSET_PEAK_PRE_WINDOW( 0 ), ONSET_PEAK_POST_WINDOW( 1 ), ONSET_PEAK_MIN_INTERVAL( 0 ),
+    ONSET_FUNCTION( DETECTION_FUNCTION_FLUX ), ONSET_MULTI_RESOLUTION( false ) {
+}
+
+//the cache of another file or format is dropped
+void AudioAnalysis::setAudio( const QString &audioFilePath, const QString &audioHash, int frequency, int channels, double duration ) {
+    this->source = 0;
+    this->audioFilePath = audioFilePath;
+    this->audioHash = audioHash;
+    this->frequency = frequency;
+    this->channels = channels;
+    this->duration = duration;
+
+    if ( !this->isCaching() || !cache.load( this->getCacheFilePath() ) ||
+            cache.frequency != frequency || cache.channels != channels ) {
+        cache.clear();
+        cache.frequency = frequency;
+        cache.channels = channels;
+    }
+}
+
+//pcm of a stream which can be read only once, it has no hash, so nothing is cached,
+//the duration is known once it's decoded
+void AudioAnalysis::setSource( AudioSource *source, int frequency, int channels ) {
+    this->source = source;
+    this->audioFilePath.clear();
+    this->audioHash.clear();
+    this->frequency = frequency;
+    this->channels = channels;
+    this->duration = 0.0;
+
+    cache.clear();
+    cache.frequency = frequency;
+    cache.channels = channels;
+}
+
+//probes a file on its own decoding stream, for analysis without an Audio playing it
+bool AudioAnalysis::openAudio( const QString &audioFilePath ) {
+    QFile file( audioFilePath );
+    if ( !file.open( QIODevice::ReadOnly ) ) {
+        qWarning() << "can't read" << audioFilePath;
+        return false;
+    }
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+    hash.addData( &file );
+    file.close();
+
+    HSTREAM decodeChannel = BASS_StreamCreateFile( false, audioFilePath.toStdString().c_str(), 0, 0, BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE );
+    if ( !decodeChannel ) {
+        qWarning() << "can't decode" << audioFilePath << "BASS error" << BASS_ErrorGetCode();
+        return false;
+    }
+
+    BASS_CHANNELINFO channelInfo;
+    BASS_ChannelGetInfo( decodeChannel, &channelInfo );
+    double duration = BASS_ChannelBytes2Seconds( decodeChannel, BASS_ChannelGetLength( decodeChannel, BASS_POS_BYTE ) );
+    BASS_StreamFree( decodeChannel );
+
+    this->setAudio( audioFilePath, hash.result().toHex(), channelInfo.freq, channelInfo.chans, duration );
+    return true;
+}
+
+//where <sha1>.onset and <sha1>.cache go, set before setAudio(),
+//with an empty path the cache lives in memory only
+void AudioAnalysis::setDataDirectory( const QString &dataDirectoryPath ) {
+    this->dataDirectoryPath = dataDirectoryPath;
+}
+
+void AudioAnalysis::setObserver( Observer *observer ) {
+    this->observer = observer;
+}
+
+bool AudioAnalysis::isCaching() const {
+    return !dataDirectoryPath.isEmpty() && !audioHash.isEmpty();
+}
+
+bool AudioAnalysis::isCancelled() {
+    return observer && observer->isCancelled();
+}
+
+const AnalysisCache &AudioAnalysis::getCache() const {
+    return cache;
+}
+
+void AudioAnalysis::setCache( const AnalysisCache &cache ) {
+    this->cache = cache;
+}
+
+QString AudioAnalysis::getAudioInfoFilePath() const {
+    return QDir( dataDirectoryPath ).filePath( audioHash + ".onset" );
+}
+
+QString AudioAnalysis::getLegacyAudioInfoFilePath() const {
+    return QDir( dataDirectoryPath ).filePath( audioHash + ".txt" );
+}
+
+QString AudioAnalysis::getCacheFilePath() const {
+    return QDir( dataDirectoryPath ).filePath( audioHash + ".cache" );
+}
+
+QString AudioAnalysis::getAudioHash() const {
+    return audioHash;
+}
+
+//an audio info file which opens next to a cache of the current options needs no decoding
+//a file produced with other options, or by a version that didn't record them, isn't up to date
+bool AudioAnalysis::isAudioInfoFileUpToDate( int pcmStep, int window ) const {
+    if ( !cache.hasFlux( ONSET_WINDOW ) || !cache.hasPCM( pcmStep ) || !cache.hasResolutions( this->getResolutionFrameSizes() ) ) {
+        return false;
+    }
+
+    AnalysisFile analysisFile;
+    return QFile::exists( this->getAudioInfoFilePath() ) && analysisFile.open( this->getAudioInfoFilePath() ) &&
+           analysisFile.getOptionsFingerprint() == this->getOptionsFingerprint( pcmStep, window );
+}
+
+//FNV-1a of every option the audio info file depends on, never 0
+quint32 AudioAnalysis::getOptionsFingerprint( int pcmStep, int window ) const {
+    const qint32 options[] = {
+        ONSET_THRESHOLD_WINDOW_SIZE, qRound( ONSET_MULTIPLIER * 1000.0 ), ONSET_WINDOW,
+        ONSET_PEAK_PRE_WINDOW, ONSET_PEAK_POST_WINDOW, ONSET_PEAK_MIN_INTERVAL,
+        ( qint32 ) ONSET_FUNCTION, ONSET_MULTI_RESOLUTION ? 1 : 0, pcmStep, window
+    };
+
+    quint32 hash = 2166136261u;
+    for ( int i = 0 ; i < ( int ) ( sizeof( options ) / sizeof( options[0] ) ) ; i++ ) {
+        for ( int b = 0 ; b < 4 ; b++ ) {
+            hash = ( hash ^ ( ( ( quint32 ) options[i] >> ( 8 * b ) ) & 0xFF ) ) * 16777619u;
+        }
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+//frame sizes analysed next to the 1024 one, all with the same hop and frame centres so their frames line up
+QVector<int> AudioAnalysis::getResolutionFrameSizes() const {
+    QVector<int> frameSizes;
+    if ( ONSET_MULTI_RESOLUTION ) {
+        frameSizes << 512 << 4096;
+    }
+    return frameSizes;
+}
+
+QVector<float> AudioAnalysis::getFlux() {
+    QVector<int> frameSizes = this->getResolutionFrameSizes();
+    if ( !cache.hasFlux( ONSET_WINDOW ) || !cache.hasResolutions( frameSizes ) ) {
+        this->extractFeatures( cache.pcmStep > 0 ? cache.pcmStep : 512 );
+    }
+
+    //first frame has nothing to rise from, same as the flux cache
+    QVector< QVector<float> > functions;
+    if ( ONSET_FUNCTION == DETECTION_FUNCTION_SUPERFLUX ) {
+        functions.append( cache.features.value( FeatureExtractor::FEATURE_SUPERFLUX ).mid( 1 ) );
+        for ( int r = 0 ; r < frameSizes.size() && r < cache.resolutionSuperFlux.size() ; r++ ) {
+            functions.append( cache.resolutionSuperFlux.at( r ).mid( 1 ) );
+        }
+    } else {
+        functions.append( cache.flux );
+        for ( int r = 0 ; r < frameSizes.size() && r < cache.resolutionFlux.size() ; r++ ) {
+            functions.append( cache.resolutionFlux.at( r ).mid( 1 ) );
+        }
+    }
+
+    if ( functions.size() == 1 ) {
+        return functions.at( 0 );
+    }
+    return Transform::fuseDetectionFunctions( functions );
+}
+
+QVector<float> AudioAnalysis::getFeature( FeatureExtractor::FEATURE feature ) {
+    if ( !cache.hasFlux( ONSET_WINDOW ) ) {
+        this->extractFeatures( cache.pcmStep > 0 ? cache.pcmStep : 512 );
+    }
+
+    return cache.features.value( feature );
+}
+
+//decodes the audio once, frame features and the decimated pcm come from the same sweep
+bool AudioAnalysis::extractFeatures( int pcmStep ) {
+    //a stream source of unknown length reports progress against 0,
+    //once it's read there's nothing left to extract again
+    AudioSource *streamSource = source;
+    HSTREAM decodeChannel = 0;
+    int totalFrames = 0;
+    if ( !streamSource ) {
+        if ( audioFilePath.isEmpty() ) {
+            return false;
+        }
+
+        decodeChannel = BASS_StreamCreateFile( false, audioFilePath.toStdString().c_str(), 0, 0, BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE );
+
+        if ( !decodeChannel ) {
+            qWarning() << "can't decode" << audioFilePath << "BASS error" << BASS_ErrorGetCode();
+            return false;
+        }
+
+        QWORD length = BASS_ChannelGetLength( decodeChannel, BASS_POS_BYTE );
+        totalFrames = length == ( QWORD ) -1 ? 0 : ( int ) qMin( length / sizeof( float ) / channels, ( QWORD ) INT_MAX );
+    }
+    DecodeChannelSource fileSource( decodeChannel );
+
+    //segments of the decoded audio are analysed on the global pool while decoding goes on
+    SegmentedFeatureExtractor extractor( frequency, channels, 1024, 2048, ONSET_WINDOW == 0 );
+
+    //other resolutions are fed the same decoded pieces, shifted so their frames share the 1024 frames' centres:
+    //longer frames start earlier with zeros before the audio, shorter ones skip its first samples
+    QVector<int> frameSizes = this->getResolutionFrameSizes();
+    QVector<SegmentedFeatureExtractor *> resolutions;
+    QVector<int> resolutionSkips;
+    for ( int r = 0 ; r < frameSizes.size() ; r++ ) {
+        int offset = ( 1024 - frameSizes.at( r ) ) / 2;
+        resolutions.append( new SegmentedFeatureExtractor( frequency, channels, frameSizes.at( r ), 2048, ONSET_WINDOW == 0 ) );
+        if ( offset < 0 ) {
+            QVector<float> padding( -offset * channels, 0.0 );
+            resolutions[r]->push( padding.constData(), -offset );
+        }
+        resolutionSkips.append( qMax( 0, offset ) );
+    }
+
+    //decoding runs on its own thread a few pieces ahead, this one feeds the extractors
+    SpscRing<DecodedPiece> pieces( 8 );
+    for ( int i = 0 ; i < pieces.getCapacity() ; i++ ) {
+        pieces.at( i ).samples.resize( 16384 * channels );
+    }
+    PieceDecoder decoder( streamSource ? streamSource : &fileSource, &pieces );
+    decoder.start();
+
+    QVector<float> pcm;
+    qint64 sampleIndex = 0;
+    bool cancelled = false;
+    while ( true ) {
+        if ( this->isCancelled() ) {
+            cancelled = true;
+            break;
+        }
+
+        //wakes up now and then to see whether it was cancelled
+        DecodedPiece *piece = decoder.takePiece( 50 );
+        if ( !piece ) {
+            continue;
+        }
+
+        int sampleCount = piece->sampleCount;
+        if ( sampleCount == 0 ) {
+            decoder.returnPiece();
+            break;
+        }
+
+        const float *samples = piece->samples.constData();
+        int frameCount = sampleCount / channels;
+        extractor.push( samples, frameCount );
+        for ( int r = 0 ; r < resolutions.size() ; r++ ) {
+            int skip = qMin( resolutionSkips.at( r ), frameCount );
+            resolutions[r]->push( samples + skip * channels, frameCount - skip );
+            resolutionSkips[r] -= skip;
+        }
+
+        //every pcmStep-th interleaved sample, a trailing partial frame is dropped like the extractor drops it
+        int wholeSampleCount = frameCount * channels;
+        int first = ( pcmStep - sampleIndex % pcmStep ) % pcmStep;
+        for ( int j = first ; j < wholeSampleCount ; j += pcmStep ) {
+            pcm.append( samples[j] );
+        }
+        sampleIndex += wholeSampleCount;
+        decoder.returnPiece();
+
+        if ( observer ) {
+            observer->setProgress( ( int ) qMin( sampleIndex / channels, ( qint64 ) totalFrames ), totalFrames );
+        }
+    }
+    decoder.stop();
+    decoder.wait();
+    source = 0;
+    if ( decodeChannel ) {
+        BASS_StreamFree( decodeChannel );
+    }
+
+    if ( cancelled ) {
+        qDeleteAll( resolutions );
+        return false;
+    }
+    extractor.finish();
+
+    if ( streamSource ) {
+        duration = ( double ) sampleIndex / channels / frequency;
+    }
+
+    cache.resolutionFrameSizes = frameSizes;
+    cache.resolutionFlux.clear();
+    cache.resolutionSuperFlux.clear();
+    for ( int r = 0 ; r < resolutions.size() ; r++ ) {
+        resolutions[r]->finish();
+        cache.resolutionFlux.append( resolutions[r]->getFeature( FeatureExtractor::FEATURE_FLUX ) );
+        cache.resolutionSuperFlux.append( resolutions[r]->getFeature( FeatureExtractor::FEATURE_SUPERFLUX ) );
+    }
+    qDeleteAll( resolutions );
+
+    cache.features.resize( FeatureExtractor::FEATURE_COUNT );
+    for ( int i = 0 ; i < FeatureExtractor::FEATURE_COUNT ; i++ ) {
+        cache.features[i] = extractor.getFeature( ( FeatureExtractor::FEATURE ) i );
+    }
+
+    //flux[i] is the change from frame i to frame i + 1
+    cache.fluxWindow = ONSET_WINDOW;
+    cache.fluxHopSize = extractor.getHopSize();
+    cache.fluxFftSize = extractor.getFrameSize();
+    cache.flux = extractor.getFeature( FeatureExtractor::FEATURE_FLUX ).mid( 1 );
+    cache.pcmStep = pcmStep;
+    cache.pcm = pcm;
+    if ( this->isCaching() ) {
+        cache.save( this->getCacheFilePath() );
+    }
+
+    return true;
+}
+
+QVector<float> AudioAnalysis::getPeaks() {
+    QVector<float> peaks = this->getFlux();
+    if ( peaks.isEmpty() ) {
+        return peaks;
+    }
+
+    Transform::subtractThreshold( peaks, ONSET_THRESHOLD_WINDOW_SIZE, ONSET_MULTIPLIER, QThreadPool::globalInstance() );
+
+    return Transform::pickPeaks( peaks, ONSET_PEAK_PRE_WINDOW, ONSET_PEAK_POST_WINDOW, ONSET_PEAK_MIN_INTERVAL );
+
+    //    int PEAK_CLEAN_WINDOW = 4;
+    //    for ( int i = 0 ; i < peaks.size() - PEAK_CLEAN_WINDOW ; i++ ) {
+    //        int peakCount = 0;
+    //        for ( int j = 0 ; j < PEAK_CLEAN_WINDOW ; j++ ) {
+    //            if ( peaks.at( i + j ) > 0.0 ) {
+    //                peakCount++;
+    //            }
+    //        }
+    //        int mid = peakCount % 2 == 0 ? i + peakCount / 2 : i + peakCount / 2 + 1;
+    //        for ( int j = 0 ; j < peakCount / 2 ; j++ ) {
+    //            peaks[mid + j] = 0.0;
+    //            peaks[mid - j] = 0.0;
+    //        }
+    //        sampleProcessingDialog.addSampleProcessed();
+    //    }
+
+    //    int PEAK_CLEAN_WINDOW = 3;
+    //    for ( int i = 0 ; i < peaks.size() - PEAK_CLEAN_WINDOW ; i++ ) {
+    //        int peakCount = 0;
+    //        for ( int j = 0 ; j < PEAK_CLEAN_WINDOW ; j++ ) {
+    //            if ( peaks.at( i + j ) > 0.0 ) {
+    //                peakCount++;
+    //            }
+    //        }
+    //        if ( peakCount > 1 ) {
+    //            for ( int j = 1 ; j < peakCount ; j++ ) {
+    //                peaks[i + j] = 0.0;
+    //            }
+    //        }
+    //        sampleProcessingDialog.addSampleProcessed();
+    //    }
+}
+
+//empty without audio, extractFeatures() has nothing to decode then
+QVector<float> AudioAnalysis::getPCM( int pcmStep ) {
+    if ( !cache.hasPCM( pcmStep ) ) {
+        this->extractFeatures( pcmStep );
+    }
+
+    return cache.pcm;
+}
+
+void AudioAnalysis::setOnsetOptions( int onsetThresholdWindowSize, float onsetMultipler, bool window ) {
+    if ( onsetThresholdWindowSize < 1 ||
+            onsetMultipler < 1.0 || onsetMultipler > 2.0 ) {
+        return;
+    }
+    ONSET_THRESHOLD_WINDOW_SIZE = onsetThresholdWindowSize;
+    ONSET_MULTIPLIER = onsetMultipler;
+    ONSET_WINDOW = window ? 0 : BASS_DATA_FFT_NOWINDOW;
+}
+
+void AudioAnalysis::setPeakOptions( int preWindow, int postWindow, int minInterval ) {
+    ONSET_PEAK_PRE_WINDOW = qBound( 0, preWindow, MAX_PEAK_WINDOW );
+    ONSET_PEAK_POST_WINDOW = qBound( 0, postWindow, MAX_PEAK_WINDOW );
+    ONSET_PEAK_MIN_INTERVAL = qBound( 0, minInterval, MAX_PEAK_MIN_INTERVAL );
+}
+
+void AudioAnalysis::setDetectionFunction( DETECTION_FUNCTION detectionFunction ) {
+    ONSET_FUNCTION = detectionFunction;
+}
+
+void AudioAnalysis::setMultiResolution( bool multiResolution ) {
+    ONSET_MULTI_RESOLUTION = multiResolution;
+}
+
+bool AudioAnalysis::produceAudioInfoFile( int pcmStep, int window ) {
+    AnalysisResult result;
+    if ( !this->analyse( result, pcmStep, window ) ) {
+        //an analysis of other options doesn't describe this one,
+        //a cancelled one leaves the previous file alone
+        if ( !this->isCancelled() ) {
+            QFile::remove( this->getAudioInfoFilePath() );
+        }
+        return false;
+    }
+
+    return AnalysisFile::write( this->getAudioInfoFilePath(), result );
+}
+
+//what produceAudioInfoFile() writes, false when cancelled or when there's nothing to write
+bool AudioAnalysis::analyse( AnalysisResult &result, int pcmStep, int window ) {
+    if ( !cache.hasFlux( ONSET_WINDOW ) || !cache.hasPCM( pcmStep ) || !cache.hasResolutions( this->getResolutionFrameSizes() ) ) {
+        this->extractFeatures( pcmStep );
+    }
+
+    if ( this->isCancelled() ) {
+        return false;
+    }
+
+    //output onsets
+    QVector<float> peaks = this->getPeaks();
+    int N = peaks.length();
+    if ( N <= 0 ) {
+        return false;
+    }
+
+    QVector<float> onsetTime;
+    QVector<float> onsetValue;
+    for ( int i = 0; i < N ; i++ ) {
+        double positionSeconds = i * ( 2048.0 / frequency );
+        if ( peaks.at( i ) > 0.0 ) {
+            onsetTime.append( positionSeconds );
+            onsetValue.append( peaks.at( i ) );
+        }
+    }
+
+    //output avg pcm
+    QVector<float> rawPCM = this->getPCM( pcmStep );
+    QVector<double> squarePrefixSums = Transform::getSquarePrefixSums( rawPCM );
+    QVector<float> avgPCM = Transform::getSlidingRMS( squarePrefixSums, window );
+
+    double meanAll = qSqrt( squarePrefixSums.last() / rawPCM.length() );
+
+    N = avgPCM.length();
+    if ( N <= 0 ) {
+        return false;
+    }
+
+    QVector<float> stressTime;
+    QVector<float> stressValue;
+    stressTime.reserve( N );
+    stressValue.reserve( N );
+    for ( int i = 0; i < N ; i++ ) {
+        double positionSeconds = ( double ) ( i * pcmStep ) / frequency / channels;
+        stressTime.append( positionSeconds );
+        stressValue.append( avgPCM.at( i ) );
+    }
+
+    double audioDuration = duration;
+    double stressStep = ( double ) pcmStep / frequency / channels;
+    QVector<Period> periods = getPeriods( avgPCM, meanAll, stressStep, audioDuration );
+
+    result = AnalysisResult();
+    result.meanAll = meanAll;
+    result.duration = audioDuration;
+    result.onsetFrameDuration = 2048.0 / frequency;
+    result.stressStep = stressStep;
+    result.onsetTime = onsetTime;
+    result.onsetValue = onsetValue;
+    result.stressTime = stressTime;
+    result.stressValue = stressValue;
+    result.optionsFingerprint = this->getOptionsFingerprint( pcmStep, window );
+    for ( int i = 0 ; i < periods.length() ; i++ ) {
+        Period period = periods.at( i );
+        result.periods << period.periodType << period.periodBegin << period.periodEnd;
+    }
+
+    return !this->isCancelled();
+}
+
+//danger where the envelope is at or above the threshold, dangers closer than mergeGap are joined,
+//gaps between them are caution, or safe for the first safeLead seconds when they're long enough
+QVector<AudioAnalysis::Period> AudioAnalysis::getPeriods( const QVector<float> &envelope, double threshold, double step, double duration,
+        double mergeGap, double safeLead ) {
+    QVector<Period> periods;
+
+    bool onPeriod = false;
+    bool pending = false;
+    double periodBegin = 0.0;
+    double pendingBegin = 0.0;
+    double pendingEnd = 0.0;
+    int N = envelope.length();
+    for ( int i = 0 ; i < N ; i++ ) {
+        double val = envelope.at( i );
+        if ( !onPeriod ) {
+            if ( val >= threshold ) {
+                onPeriod = true;
+                periodBegin = i * step;
+            }
+            continue;
+        }
+
+        if ( val >= threshold ) {
+            continue;
+        }
+
+        onPeriod = false;
+        double periodEnd = i * step;
+        if ( pending && periodBegin - pendingEnd < mergeGap ) {
+            pendingEnd = periodEnd;
+            continue;
+        }
+
+        if ( pending ) {
+            appendDangerPeriod( periods, pendingBegin, pendingEnd, safeLead );
+        }
+        pending = true;
+        pendingBegin = periodBegin;
+        pendingEnd = periodEnd;
+    }
+
+    if ( pending ) {
+        appendDangerPeriod( periods, pendingBegin, pendingEnd, safeLead );
+    }
+
+    if ( periods.length() > 0 && periods.last().periodEnd < duration ) {
+        periods.append( Period( PERIOD_TYPE_SAFE, periods.last().periodEnd, duration ) );
+    }
+
+    return periods;
+}
+
+void AudioAnalysis::appendDangerPeriod( QVector<Period> &periods, double periodBegin, double periodEnd, double safeLead ) {
+    double gapBegin = periods.isEmpty() ? 0.0 : periods.last().periodEnd;
+    bool first = periods.isEmpty();
+
+    if ( first ? periodBegin > safeLead : periodBegin - gapBegin >= safeLead ) {
+        periods.append( Period( PERIOD_TYPE_SAFE, gapBegin, gapBegin + safeLead ) );
+        periods.append( Period( PERIOD_TYPE_CAUTION, gapBegin + safeLead, periodBegin ) );
+    } else if ( !first || periodBegin > 0.0 ) {
+        periods.append( Period( PERIOD_TYPE_CAUTION, gapBegin, periodBegin ) );
+    }
+
+    periods.append( Period( PERIOD_TYPE_DANGER, periodBegin, periodEnd ) );
+}
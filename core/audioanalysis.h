@@ -0,0 +1,119 @@
+#ifndef AUDIOANALYSIS_H
+#define AUDIOANALYSIS_H
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QVector>
+#include "bass.h"
+#include "qmath.h"
+#include "transform.h"
+#include "analysiscache.h"
+#include "analysisfile.h"
+#include "audiosource.h"
+#include "featureextractor.h"
+#include "segmentedfeatureextractor.h"
+
+//onset and stress analysis of one audio file, decoded on its own stream so it doesn't
+//touch playback; a plain value, a copy can be analysed on another thread
+class AudioAnalysis {
+
+public:
+    enum                                PERIOD_TYPE {
+        PERIOD_TYPE_SAFE = 0,
+        PERIOD_TYPE_CAUTION = 1,
+        PERIOD_TYPE_DANGER = 2
+    };
+
+    struct                              Period {
+        PERIOD_TYPE                     periodType;
+        double                          periodBegin;
+        double                          periodEnd;
+
+        Period() {}
+        Period( PERIOD_TYPE periodType, double periodBegin, double periodEnd ) :
+            periodType( periodType ), periodBegin( periodBegin ), periodEnd( periodEnd ) {}
+    };
+
+    //limits of the peak options, the same as the window's spin boxes
+    static const int                    MAX_PEAK_WINDOW = 64;
+    static const int                    MAX_PEAK_MIN_INTERVAL = 256;
+
+    enum                                DETECTION_FUNCTION {
+        DETECTION_FUNCTION_FLUX = 0,
+        DETECTION_FUNCTION_SUPERFLUX = 1
+    };
+
+    //called from the analysing thread, decoding stops once isCancelled() returns true
+    class                               Observer {
+
+    public:
+        virtual                         ~Observer() {}
+        virtual bool                    isCancelled() = 0;
+        virtual void                    setProgress( int processed, int total ) = 0;
+    };
+
+                                        AudioAnalysis();
+
+    void                                setAudio( const QString &audioFilePath, const QString &audioHash, int frequency, int channels, double duration );
+    bool                                openAudio( const QString &audioFilePath );
+    void                                setSource( AudioSource *source, int frequency, int channels );
+    void                                setDataDirectory( const QString &dataDirectoryPath );
+    void                                setObserver( Observer *observer );
+
+    QString                             getAudioInfoFilePath() const;
+    QString                             getLegacyAudioInfoFilePath() const;
+    QString                             getCacheFilePath() const;
+    QString                             getAudioHash() const;
+    bool                                isAudioInfoFileUpToDate( int pcmStep = 512, int window = 256 ) const;
+    quint32                             getOptionsFingerprint( int pcmStep = 512, int window = 256 ) const;
+
+    const AnalysisCache                 &getCache() const;
+    void                                setCache( const AnalysisCache &cache );
+
+    QVector<float>                      getFlux();
+    QVector<float>                      getFeature( FeatureExtractor::FEATURE feature );
+    QVector<float>                      getPeaks();
+    QVector<float>                      getPCM( int pcmStep = 512 );
+    void                                setOnsetOptions( int onsetThresholdWindowSize, float onsetMultipler, bool window );
+    void                                setPeakOptions( int preWindow, int postWindow, int minInterval );
+    void                                setDetectionFunction( DETECTION_FUNCTION detectionFunction );
+    void                                setMultiResolution( bool multiResolution );
+
+    bool                                produceAudioInfoFile( int pcmStep = 512, int window = 256 );
+    bool                                analyse( AnalysisResult &result, int pcmStep = 512, int window = 256 );
+
+    static QVector<Period>              getPeriods( const QVector<float> &envelope, double threshold, double step, double duration,
+                                                    double mergeGap = 3.0, double safeLead = 15.0 );
+
+private:
+    QString                             audioFilePath;
+    QString                             audioHash;
+    QString                             dataDirectoryPath;
+    int                                 frequency;
+    int                                 channels;
+    double                              duration;
+    AudioSource                         *source;
+    Observer                            *observer;
+
+    int                                 ONSET_THRESHOLD_WINDOW_SIZE;
+    double                              ONSET_MULTIPLIER;
+    int                                 ONSET_WINDOW;
+    int                                 ONSET_PEAK_PRE_WINDOW;
+    int                                 ONSET_PEAK_POST_WINDOW;
+    int                                 ONSET_PEAK_MIN_INTERVAL;
+    DETECTION_FUNCTION                  ONSET_FUNCTION;
+    bool                                ONSET_MULTI_RESOLUTION;
+
+    AnalysisCache                       cache;
+
+    QVector<int>                        getResolutionFrameSizes() const;
+    bool                                extractFeatures( int pcmStep );
+    bool                                isCaching() const;
+    bool                                isCancelled();
+
+    static void                         appendDangerPeriod( QVector<Period> &periods, double periodBegin, double periodEnd, double safeLead );
+};
+
+#endif // AUDIOANALYSIS_H
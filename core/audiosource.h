@@ -0,0 +1,15 @@
+#ifndef AUDIOSOURCE_H
+#define AUDIOSOURCE_H
+
+//interleaved float samples for AudioAnalysis, read once from start to end
+//on the analysis' decoding thread; implemented for decoded pcm which isn't in a file BASS can open
+class AudioSource {
+
+public:
+    virtual                             ~AudioSource() {}
+
+    //fills up to maxSampleCount samples, whole frames except at the end, 0 once the source ended
+    virtual int                         read( float *samples, int maxSampleCount ) = 0;
+};
+
+#endif // AUDIOSOURCE_H
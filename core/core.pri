@@ -0,0 +1,15 @@
+# included by targets linking the analysis core, after their own CONFIG
+
+INCLUDEPATH += $$PWD $$PWD/..
+DEPENDPATH += $$PWD
+
+win32:CONFIG(release, debug|release): ONSETCORE_DIR = $$OUT_PWD/../core/release
+else:win32:CONFIG(debug, debug|release): ONSETCORE_DIR = $$OUT_PWD/../core/debug
+else: ONSETCORE_DIR = $$OUT_PWD/../core
+
+LIBS += -L$$ONSETCORE_DIR -lonsetcore
+
+win32-msvc*: PRE_TARGETDEPS += $$ONSETCORE_DIR/onsetcore.lib
+else: PRE_TARGETDEPS += $$ONSETCORE_DIR/libonsetcore.a
+
+LIBS += -L$$PWD/.. -lbass
@@ -0,0 +1,46 @@
+#-------------------------------------------------
+#
+# Decoding, feature extraction, onset detection and
+# audio info files, QtCore and BASS only
+#
+#-------------------------------------------------
+
+QT       = core
+
+TARGET = onsetcore
+TEMPLATE = lib
+
+CONFIG += c++17 staticlib
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += analysiscache.cpp \
+    analysisfile.cpp \
+    analysismigration.cpp \
+    analysisbatch.cpp \
+    analysisoptions.cpp \
+    audioanalysis.cpp \
+    rawpcmsource.cpp \
+    livetap.cpp \
+    featureextractor.cpp \
+    onlineonsetdetector.cpp \
+    filterbank.cpp \
+    segmentedfeatureextractor.cpp \
+    transform.cpp
+
+HEADERS += analysiscache.h \
+    analysisfile.h \
+    analysismigration.h \
+    analysisbatch.h \
+    analysisoptions.h \
+    audioanalysis.h \
+    audiosource.h \
+    decodechannelsource.h \
+    rawpcmsource.h \
+    livetap.h \
+    featureextractor.h \
+    onlineonsetdetector.h \
+    filterbank.h \
+    segmentedfeatureextractor.h \
+    spscring.h \
+    transform.h
@@ -0,0 +1,23 @@
+#ifndef DECODECHANNELSOURCE_H
+#define DECODECHANNELSOURCE_H
+
+#include "bass.h"
+#include "audiosource.h"
+
+//a file decoded by BASS, the channel has to be created with BASS_SAMPLE_FLOAT | BASS_STREAM_DECODE
+class DecodeChannelSource : public AudioSource {
+
+public:
+                                        DecodeChannelSource( HSTREAM decodeChannel ) :
+        decodeChannel( decodeChannel ) {}
+
+    int                                 read( float *samples, int maxSampleCount ) {
+        DWORD bytes = BASS_ChannelGetData( decodeChannel, samples, maxSampleCount * sizeof( float ) );
+        return bytes == ( DWORD ) -1 ? 0 : bytes / sizeof( float );
+    }
+
+private:
+    HSTREAM                             decodeChannel;
+};
+
+#endif // DECODECHANNELSOURCE_H
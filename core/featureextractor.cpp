@@ -0,0 +1,293 @@
+#include "featureextractor.h"
+#include "transform.h"
+#include <cstring>
+
+FeatureExtractor::FeatureExtractor( int frequency, int channels, int frameSize, int hopSize, bool window ) :
+    frequency( frequency ),
+    channels( qMax( 1, channels ) ),
+    frameSize( 2 ),
+    hopSize( qMax( 1, hopSize ) ),
+    hopSquares( 0.0 ), hopPeak( 0.0 ), hopCrossings( 0 ), hopSamples( 0 ),
+    lastMono( 0.0 ), hasLastMono( false ),
+    position( 0 ), nextFrameStart( 0 ), pendingStart( 0 ),
+    hasPrevious( false ) {
+
+    //radix-2 fft, frame size goes up to a power of two
+    while ( this->frameSize < frameSize ) {
+        this->frameSize *= 2;
+    }
+    int N = this->frameSize;
+
+    windowTable.resize( N );
+    for ( int i = 0 ; i < N ; i++ ) {
+        windowTable[i] = window ? 0.5 - 0.5 * qCos( 2 * M_PI * i / N ) : 1.0;
+    }
+
+    cosTable.resize( N / 2 );
+    sinTable.resize( N / 2 );
+    for ( int i = 0 ; i < N / 2 ; i++ ) {
+        cosTable[i] = qCos( 2 * M_PI * i / N );
+        sinTable[i] = -qSin( 2 * M_PI * i / N );
+    }
+
+    int bits = 0;
+    while ( ( 1 << bits ) < N ) {
+        bits++;
+    }
+    bitReverse.resize( N );
+    for ( int i = 0 ; i < N ; i++ ) {
+        int reversed = 0;
+        for ( int b = 0 ; b < bits ; b++ ) {
+            reversed |= ( ( i >> b ) & 1 ) << ( bits - 1 - b );
+        }
+        bitReverse[i] = reversed;
+    }
+
+    re.resize( N );
+    im.resize( N );
+    magnitudes.resize( N / 2 );
+    previousMagnitudes.resize( N / 2 );
+
+    double maxFrequency = qMin( ( double ) Filterbank::MAX_FREQUENCY, frequency / 2.0 );
+    int bandCount = qMax( 1, qRound( BANDS_PER_OCTAVE * log2( maxFrequency / Filterbank::MIN_FREQUENCY ) ) );
+    filterbank = Filterbank::get( frequency, N, bandCount, Filterbank::SCALE_LOG );
+    bands.resize( filterbank->getBandCount() );
+    previousBandMaxima.resize( filterbank->getBandCount() );
+    bandMaxima.resize( filterbank->getBandCount() );
+    bandMaxPrefix.resize( filterbank->getBandCount() );
+    bandMaxSuffix.resize( filterbank->getBandCount() );
+}
+
+void FeatureExtractor::push( const float *samples, int frameCount ) {
+    for ( int f = 0 ; f < frameCount ; f++ ) {
+        const float *frame = samples + f * channels;
+
+        float mono = 0.0;
+        for ( int c = 0 ; c < channels ; c++ ) {
+            float value = frame[c];
+            hopSquares += value * value;
+            hopPeak = qMax( hopPeak, qAbs( value ) );
+            mono += value;
+        }
+        mono /= channels;
+
+        if ( hasLastMono && ( mono >= 0.0 ) != ( lastMono >= 0.0 ) ) {
+            hopCrossings++;
+        }
+        lastMono = mono;
+        hasLastMono = true;
+
+        //samples between a short frame and the next hop aren't kept
+        if ( position >= nextFrameStart ) {
+            if ( pending.isEmpty() ) {
+                pendingStart = position;
+            }
+            pending.append( mono );
+        }
+        position++;
+
+        if ( ++hopSamples == hopSize ) {
+            this->finishHop();
+        }
+        if ( nextFrameStart + frameSize <= position ) {
+            this->processFrames();
+        }
+    }
+}
+
+void FeatureExtractor::finish() {
+    if ( hopSamples > 0 ) {
+        this->finishHop();
+    }
+
+    //frames running past the end are zero padded
+    while ( nextFrameStart < position ) {
+        QVector<float> frame( frameSize, 0.0 );
+        int offset = nextFrameStart - pendingStart;
+        int available = qMax( 0, qMin( frameSize, pending.size() - offset ) );
+        if ( available > 0 ) {
+            memcpy( frame.data(), pending.constData() + offset, available * sizeof( float ) );
+        }
+        this->processFrame( frame.constData() );
+        nextFrameStart += hopSize;
+    }
+    pending.clear();
+}
+
+//starts over at sample 0 keeping the tables, so restarting a stream doesn't rebuild them
+void FeatureExtractor::reset() {
+    hopSquares = 0.0;
+    hopPeak = 0.0;
+    hopCrossings = 0;
+    hopSamples = 0;
+    lastMono = 0.0;
+    hasLastMono = false;
+
+    position = 0;
+    nextFrameStart = 0;
+    pendingStart = 0;
+    pending.clear();
+
+    previousMagnitudes.fill( 0.0 );
+    previousBandMaxima.fill( 0.0 );
+    hasPrevious = false;
+
+    for ( int f = 0 ; f < FEATURE_COUNT ; f++ ) {
+        features[f].clear();
+    }
+}
+
+int FeatureExtractor::getFrameCount() const {
+    return features[FEATURE_FLUX].size();
+}
+
+int FeatureExtractor::getFrameSize() const {
+    return frameSize;
+}
+
+int FeatureExtractor::getHopSize() const {
+    return hopSize;
+}
+
+const QVector<float> &FeatureExtractor::getFeature( FEATURE feature ) const {
+    return features[feature];
+}
+
+void FeatureExtractor::finishHop() {
+    features[FEATURE_RMS].append( qSqrt( hopSquares / ( ( double ) hopSamples * channels ) ) );
+    features[FEATURE_PEAK].append( hopPeak );
+    features[FEATURE_ZCR].append( ( float ) hopCrossings / hopSamples );
+
+    hopSquares = 0.0;
+    hopPeak = 0.0;
+    hopCrossings = 0;
+    hopSamples = 0;
+}
+
+void FeatureExtractor::processFrames() {
+    while ( nextFrameStart + frameSize <= position ) {
+        this->processFrame( pending.constData() + ( nextFrameStart - pendingStart ) );
+        nextFrameStart += hopSize;
+    }
+
+    //drop what no later frame needs
+    int drop = qMin( ( qint64 ) pending.size(), nextFrameStart - pendingStart );
+    if ( drop > 0 ) {
+        pending.remove( 0, drop );
+        pendingStart += drop;
+    }
+}
+
+void FeatureExtractor::processFrame( const float *frame ) {
+    float values[FEATURE_COUNT];
+    this->analyseFrame( frame, values );
+    features[FEATURE_CENTROID].append( values[FEATURE_CENTROID] );
+    features[FEATURE_FLUX].append( values[FEATURE_FLUX] );
+    features[FEATURE_HFC].append( values[FEATURE_HFC] );
+    features[FEATURE_SUPERFLUX].append( values[FEATURE_SUPERFLUX] );
+}
+
+//spectral entries of values for the next frame of frameSize mono samples, for callers doing their own framing,
+//allocates nothing so it can run on an audio thread
+void FeatureExtractor::analyseFrame( const float *frame, float *values ) {
+    int N = frameSize;
+    for ( int i = 0 ; i < N ; i++ ) {
+        re[bitReverse[i]] = frame[i] * windowTable[i];
+        im[i] = 0.0;
+    }
+
+    this->fft();
+
+    //amplitude spectrum, a full scale sine is about 1 without window
+    float scale = 2.0 / N;
+    double magnitudeSum = 0.0;
+    double weightedSum = 0.0;
+    double hfc = 0.0;
+    double flux = 0.0;
+    for ( int k = 0 ; k < N / 2 ; k++ ) {
+        float magnitude = qSqrt( re[k] * re[k] + im[k] * im[k] ) * scale;
+        magnitudes[k] = magnitude;
+        magnitudeSum += magnitude;
+        weightedSum += k * magnitude;
+        hfc += k * magnitude * magnitude;
+
+        float rise = magnitude - previousMagnitudes[k];
+        flux += rise > 0.0 ? rise : 0.0;
+    }
+
+    double binWidth = ( double ) frequency / N;
+    values[FEATURE_CENTROID] = magnitudeSum > 0.0 ? weightedSum / magnitudeSum * binWidth : 0.0;
+    values[FEATURE_FLUX] = hasPrevious ? flux : 0.0;
+    values[FEATURE_HFC] = hfc;
+    values[FEATURE_SUPERFLUX] = this->getSuperFlux();
+
+    magnitudes.swap( previousMagnitudes );
+    hasPrevious = true;
+}
+
+//in place iterative radix-2, input already in bit reversed order
+void FeatureExtractor::fft() {
+    int N = frameSize;
+    float *xr = re.data();
+    float *xi = im.data();
+
+    for ( int size = 2 ; size <= N ; size *= 2 ) {
+        int half = size / 2;
+        int tableStep = N / size;
+        for ( int start = 0 ; start < N ; start += size ) {
+            for ( int j = 0 ; j < half ; j++ ) {
+                float wr = cosTable[j * tableStep];
+                float wi = sinTable[j * tableStep];
+                int a = start + j;
+                int b = a + half;
+                float tr = xr[b] * wr - xi[b] * wi;
+                float ti = xr[b] * wi + xi[b] * wr;
+                xr[b] = xr[a] - tr;
+                xi[b] = xi[a] - ti;
+                xr[a] += tr;
+                xi[a] += ti;
+            }
+        }
+    }
+}
+
+//SuperFlux (Boeck, Widmer 2013) with a lag of one frame,
+//vibrato moving a partial by a band doesn't count as a rise
+float FeatureExtractor::getSuperFlux() {
+    int bandCount = bands.size();
+    if ( bandCount == 0 ) {
+        return 0.0;
+    }
+
+    //log(1 + magnitude) on the unscaled spectrum
+    float logScale = frameSize / 2.0;
+    filterbank->apply( magnitudes.constData(), 1, magnitudes.size(), bands.data() );
+    for ( int b = 0 ; b < bandCount ; b++ ) {
+        bands[b] = log10f( 1.0 + logScale * bands[b] );
+    }
+
+    float flux = 0.0;
+    if ( hasPrevious ) {
+        for ( int b = 0 ; b < bandCount ; b++ ) {
+            float rise = bands[b] - previousBandMaxima[b];
+            flux += rise > 0.0 ? rise : 0.0;
+        }
+    }
+
+    //max over [b - radius, b + radius] with the window clipped at both ends
+    int width = 2 * BAND_MAX_FILTER_RADIUS + 1;
+    Transform::slidingMax( bands.constData(), bandCount, width, bandMaxima.data(), bandMaxPrefix.data(), bandMaxSuffix.data() );
+    float running = bands[0];
+    for ( int b = 0 ; b < bandCount ; b++ ) {
+        if ( b >= BAND_MAX_FILTER_RADIUS ) {
+            previousBandMaxima[b] = bandMaxima[b - BAND_MAX_FILTER_RADIUS];
+        } else {
+            for ( int k = 0 ; k <= qMin( bandCount - 1, b + BAND_MAX_FILTER_RADIUS ) ; k++ ) {
+                running = qMax( running, bands[k] );
+            }
+            previousBandMaxima[b] = running;
+        }
+    }
+
+    return flux;
+}
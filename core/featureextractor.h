@@ -0,0 +1,88 @@
+#ifndef FEATUREEXTRACTOR_H
+#define FEATUREEXTRACTOR_H
+
+#include <QVector>
+#include "qmath.h"
+#include "filterbank.h"
+
+//computes per-frame features of interleaved float samples in one sweep,
+//samples are pushed in pieces of any size as they're decoded.
+//frame k starts at sample k * hopSize of every channel, time domain features
+//cover [k * hopSize, (k + 1) * hopSize), spectral ones frameSize samples of the mono mix from there
+class FeatureExtractor {
+
+public:
+    enum                                FEATURE {
+        FEATURE_RMS = 0,                //all channels
+        FEATURE_PEAK = 1,               //max absolute sample of all channels
+        FEATURE_ZCR = 2,                //sign changes of the mono mix per sample
+        FEATURE_CENTROID = 3,           //Hz
+        FEATURE_FLUX = 4,               //positive magnitude change from the previous frame, 0 for the first one
+        FEATURE_HFC = 5,                //sum of bin * magnitude^2
+        FEATURE_SUPERFLUX = 6,          //positive change of log bands from the frequency max filtered previous frame
+        FEATURE_COUNT = 7
+    };
+
+                                        FeatureExtractor( int frequency, int channels, int frameSize = 1024, int hopSize = 2048, bool window = true );
+
+    void                                push( const float *samples, int frameCount );
+    void                                finish();
+    void                                reset();
+
+    int                                 getFrameCount() const;
+    int                                 getFrameSize() const;
+    int                                 getHopSize() const;
+    const QVector<float>                &getFeature( FEATURE feature ) const;
+
+    void                                analyseFrame( const float *frame, float *values );
+
+private:
+    int                                 frequency;
+    int                                 channels;
+    int                                 frameSize;
+    int                                 hopSize;
+
+    //current hop
+    double                              hopSquares;
+    float                               hopPeak;
+    int                                 hopCrossings;
+    int                                 hopSamples;
+    float                               lastMono;
+    bool                                hasLastMono;
+
+    //mono samples from pendingStart on, still needed by a frame
+    qint64                              position;
+    qint64                              nextFrameStart;
+    qint64                              pendingStart;
+    QVector<float>                      pending;
+
+    QVector<float>                      windowTable;
+    QVector<float>                      cosTable;
+    QVector<float>                      sinTable;
+    QVector<int>                        bitReverse;
+    QVector<float>                      re;
+    QVector<float>                      im;
+    QVector<float>                      magnitudes;
+    QVector<float>                      previousMagnitudes;
+    bool                                hasPrevious;
+
+    QSharedPointer<const Filterbank>    filterbank;
+    QVector<float>                      bands;
+    QVector<float>                      previousBandMaxima;
+    QVector<float>                      bandMaxima;             //slidingMax output and scratch, sized once
+    QVector<float>                      bandMaxPrefix;
+    QVector<float>                      bandMaxSuffix;
+
+    static const int                    BANDS_PER_OCTAVE = 24;
+    static const int                    BAND_MAX_FILTER_RADIUS = 1;
+
+    QVector<float>                      features[FEATURE_COUNT];
+
+    void                                finishHop();
+    void                                processFrame( const float *frame );
+    void                                processFrames();
+    void                                fft();
+    float                               getSuperFlux();
+};
+
+#endif // FEATUREEXTRACTOR_H
@@ -0,0 +1,112 @@
+#include "filterbank.h"
+
+const float Filterbank::MIN_FREQUENCY = 27.5;
+const float Filterbank::MAX_FREQUENCY = 16000.0;
+
+QMutex Filterbank::cacheMutex;
+QMap<QString, QSharedPointer<const Filterbank> > Filterbank::cache;
+
+QSharedPointer<const Filterbank> Filterbank::get( int frequency, int fftSize, int bandCount, SCALE scale ) {
+    QString key = QString( "%1/%2/%3/%4" ).arg( frequency ).arg( fftSize ).arg( bandCount ).arg( scale );
+
+    QMutexLocker locker( &cacheMutex );
+    QSharedPointer<const Filterbank> filterbank = cache.value( key );
+    if ( filterbank.isNull() ) {
+        filterbank = QSharedPointer<const Filterbank>( new Filterbank( frequency, fftSize, bandCount, scale ) );
+        cache.insert( key, filterbank );
+    }
+    return filterbank;
+}
+
+static double toMel( double frequency ) {
+    return 2595.0 * log10( 1.0 + frequency / 700.0 );
+}
+
+static double fromMel( double mel ) {
+    return 700.0 * ( qPow( 10.0, mel / 2595.0 ) - 1.0 );
+}
+
+Filterbank::Filterbank( int frequency, int fftSize, int bandCount, SCALE scale ) :
+    binCount( fftSize / 2 ) {
+
+    double binWidth = ( double ) frequency / fftSize;
+    double minFrequency = MIN_FREQUENCY;
+    double maxFrequency = qMin( ( double ) MAX_FREQUENCY, frequency / 2.0 );
+    if ( binCount < 1 || bandCount < 1 || maxFrequency <= minFrequency ) {
+        binCount = qMax( 0, binCount );
+        return;
+    }
+
+    //band b rises from centers[b] to centers[b + 1] and falls to centers[b + 2]
+    QVector<int> centers;
+    for ( int i = 0 ; i < bandCount + 2 ; i++ ) {
+        double position = ( double ) i / ( bandCount + 1 );
+        double f = scale == SCALE_MEL ?
+                   fromMel( toMel( minFrequency ) + position * ( toMel( maxFrequency ) - toMel( minFrequency ) ) ) :
+                   minFrequency * qPow( maxFrequency / minFrequency, position );
+        int bin = qMin( binCount - 1, qRound( f / binWidth ) );
+        if ( scale == SCALE_LOG && !centers.isEmpty() && bin <= centers.last() ) {
+            continue;
+        }
+        centers.append( bin );
+    }
+
+    for ( int b = 0 ; b + 2 < centers.size() ; b++ ) {
+        int low = centers.at( b );
+        int center = centers.at( b + 1 );
+        int high = centers.at( b + 2 );
+
+        //bins strictly inside the triangle, the center always
+        int first = center > low ? low + 1 : center;
+        int last = high > center ? high - 1 : center;
+
+        start.append( first );
+        length.append( last - first + 1 );
+        offset.append( weights.size() );
+
+        //normalized to unit area
+        int bandOffset = weights.size();
+        float sum = 0.0;
+        for ( int k = first ; k <= last ; k++ ) {
+            float weight = k < center ? ( float ) ( k - low ) / ( center - low ) :
+                           k > center ? ( float ) ( high - k ) / ( high - center ) : 1.0;
+            weights.append( weight );
+            sum += weight;
+        }
+        for ( int k = bandOffset ; k < weights.size() ; k++ ) {
+            weights[k] /= sum;
+        }
+    }
+}
+
+int Filterbank::getBandCount() const {
+    return start.size();
+}
+
+int Filterbank::getBinCount() const {
+    return binCount;
+}
+
+//weights of a band are contiguous, the inner loop is a plain dot product the compiler vectorizes
+void Filterbank::apply( const float *spectra, int frameCount, int binStride, float *bands ) const {
+    int bandCount = start.size();
+    const int *bandStart = start.constData();
+    const int *bandLength = length.constData();
+    const int *bandOffset = offset.constData();
+    const float *w = weights.constData();
+
+    for ( int frame = 0 ; frame < frameCount ; frame++ ) {
+        const float *bins = spectra + ( qint64 ) frame * binStride;
+        float *out = bands + ( qint64 ) frame * bandCount;
+
+        for ( int b = 0 ; b < bandCount ; b++ ) {
+            const float *x = bins + bandStart[b];
+            const float *y = w + bandOffset[b];
+            float sum = 0.0;
+            for ( int k = 0 ; k < bandLength[b] ; k++ ) {
+                sum += x[k] * y[k];
+            }
+            out[b] = sum;
+        }
+    }
+}
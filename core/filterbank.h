@@ -0,0 +1,46 @@
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <QVector>
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include "qmath.h"
+
+//triangular bands over magnitude spectra, band b weights bins [start[b], start[b] + length[b])
+//with weights from offset[b] on, so applying it only touches the bins a band covers.
+//instances are shared per sample rate, fft size, band count and scale through get()
+class Filterbank {
+
+public:
+    enum                                SCALE {
+        SCALE_MEL = 0,                  //bands evenly spaced in mel, band count kept even if bands share bins
+        SCALE_LOG = 1                   //bands evenly spaced in octaves, bands sharing a center bin are merged
+    };
+
+    static QSharedPointer<const Filterbank> get( int frequency, int fftSize, int bandCount, SCALE scale );
+
+    int                                 getBandCount() const;
+    int                                 getBinCount() const;
+
+    //spectra holds frameCount rows of binStride floats, the first getBinCount() of each are used;
+    //bands gets frameCount rows of getBandCount() floats
+    void                                apply( const float *spectra, int frameCount, int binStride, float *bands ) const;
+
+    static const float                  MIN_FREQUENCY;
+    static const float                  MAX_FREQUENCY;
+
+private:
+                                        Filterbank( int frequency, int fftSize, int bandCount, SCALE scale );
+
+    int                                 binCount;
+    QVector<int>                        start;
+    QVector<int>                        length;
+    QVector<int>                        offset;
+    QVector<float>                      weights;
+
+    static QMutex                       cacheMutex;
+    static QMap<QString, QSharedPointer<const Filterbank> > cache;
+};
+
+#endif // FILTERBANK_H
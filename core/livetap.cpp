@@ -0,0 +1,157 @@
+#include "livetap.h"
+#include <QDebug>
+#include <cstring>
+
+LiveTap::LiveTap( int frequency, int channels, int lookahead, bool window ) :
+    frequency( frequency ),
+    channels( qMax( 1, channels ) ),
+    detector( frequency, channels, lookahead, window ),
+    listener( 0 ),
+    blocks( BLOCK_COUNT ),
+    stopped( 0 ),
+    channel( 0 ),
+    dsp( 0 ),
+    restartRequested( 0 ),
+    requestedStartFrame( 0 ),
+    writerStartFrame( 0 ),
+    writtenFrames( 0 ),
+    discontinuous( false ),
+    droppedFrames( 0 ),
+    startTime( 0.0 ) {
+
+    for ( int i = 0 ; i < blocks.getCapacity() ; i++ ) {
+        Block &block = blocks.at( i );
+        block.samples.resize( BLOCK_FRAMES * this->channels );
+        block.sampleCount = 0;
+        block.restart = false;
+        block.startTime = 0.0;
+    }
+    detector.setListener( this );
+}
+
+LiveTap::~LiveTap() {
+    this->detach();
+    this->stop();
+    this->wait();
+}
+
+OnlineOnsetDetector &LiveTap::getDetector() {
+    return detector;
+}
+
+void LiveTap::setListener( OnlineOnsetDetector::Listener *listener ) {
+    this->listener = listener;
+}
+
+//the channel has to deliver float samples, like a stream created with BASS_SAMPLE_FLOAT
+bool LiveTap::attach( DWORD channel ) {
+    this->detach();
+    dsp = BASS_ChannelSetDSP( channel, &LiveTap::processDsp, this, 0 );
+    if ( !dsp ) {
+        qWarning() << "can't tap channel, BASS error" << BASS_ErrorGetCode();
+        return false;
+    }
+    this->channel = channel;
+    return true;
+}
+
+void LiveTap::detach() {
+    if ( dsp ) {
+        BASS_ChannelRemoveDSP( channel, dsp );
+        dsp = 0;
+        channel = 0;
+    }
+}
+
+void CALLBACK LiveTap::processDsp( HDSP handle, DWORD channel, void *buffer, DWORD length, void *user ) {
+    Q_UNUSED( handle );
+    Q_UNUSED( channel );
+    static_cast<LiveTap *>( user )->write( static_cast<const float *>( buffer ), length / sizeof( float ) );
+}
+
+//called by the one thread producing samples, usually the audio thread: copies and returns,
+//what doesn't fit in the ring is dropped and the detection restarts after the gap
+void LiveTap::write( const float *samples, int sampleCount ) {
+    if ( restartRequested.testAndSetOrdered( 1, 0 ) ) {
+        writerStartFrame = requestedStartFrame.loadAcquire();
+        writtenFrames = 0;
+        discontinuous = true;
+    }
+
+    int frameCount = sampleCount / channels;
+    int frame = 0;
+    while ( frame < frameCount ) {
+        int count = qMin( BLOCK_FRAMES, frameCount - frame );
+        Block *block = blocks.beginWrite();
+        if ( !block ) {
+            droppedFrames.fetchAndAddRelaxed( frameCount - frame );
+            writtenFrames += frameCount - frame;
+            discontinuous = true;
+            return;
+        }
+
+        memcpy( block->samples.data(), samples + frame * channels, count * channels * sizeof( float ) );
+        block->sampleCount = count * channels;
+        block->restart = discontinuous;
+        block->startTime = ( double ) ( writerStartFrame + writtenFrames ) / frequency;
+        blocks.endWrite();
+        writtenBlocks.release();
+
+        discontinuous = false;
+        writtenFrames += count;
+        frame += count;
+    }
+}
+
+//from any thread, after a seek the samples written next are at startTime;
+//kept in sample frames so a write() racing a second restart never sees a torn value
+void LiveTap::restart( double startTime ) {
+    requestedStartFrame.storeRelease( qRound64( startTime * frequency ) );
+    restartRequested.storeRelease( 1 );
+}
+
+//no more writes, the thread finishes the queued blocks and exits
+void LiveTap::stop() {
+    stopped.storeRelease( 1 );
+    writtenBlocks.release();
+}
+
+int LiveTap::getDroppedFrameCount() const {
+    return droppedFrames.load();
+}
+
+//what was written before stop() is still analysed, then the detection is finished
+void LiveTap::run() {
+    while ( true ) {
+        //a block can be read before its release comes, then a later wake up finds the ring empty
+        writtenBlocks.acquire();
+        Block *block = blocks.beginRead();
+        if ( !block ) {
+            if ( stopped.loadAcquire() ) {
+                break;
+            }
+            continue;
+        }
+
+        if ( block->restart ) {
+            detector.reset();
+            startTime = block->startTime;
+        }
+        detector.push( block->samples.constData(), block->sampleCount / channels );
+        blocks.endRead();
+    }
+
+    detector.finish();
+}
+
+void LiveTap::onsetDetected( double time, float strength ) {
+    if ( listener ) {
+        listener->onsetDetected( startTime + time, strength );
+    }
+}
+
+void LiveTap::levelMeasured( double time, float rms ) {
+    if ( listener ) {
+        listener->levelMeasured( startTime + time, rms );
+    }
+}
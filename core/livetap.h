@@ -0,0 +1,78 @@
+#ifndef LIVETAP_H
+#define LIVETAP_H
+
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QSemaphore>
+#include <QThread>
+#include <QVector>
+#include "bass.h"
+#include "onlineonsetdetector.h"
+#include "spscring.h"
+
+//live analysis of audio while it plays: the audio thread only copies its buffers into a ring,
+//this thread runs them through an OnlineOnsetDetector and calls the listener with track times.
+//samples come from a BASS DSP on the playing channel or, headless, from whatever calls write()
+class LiveTap : public QThread, private OnlineOnsetDetector::Listener {
+
+public:
+                                        LiveTap( int frequency, int channels, int lookahead = 2, bool window = true );
+                                        ~LiveTap();
+
+    //set up before start(), the detector is only touched by this thread afterwards
+    OnlineOnsetDetector                 &getDetector();
+    void                                setListener( OnlineOnsetDetector::Listener *listener );
+
+    bool                                attach( DWORD channel );
+    void                                detach();
+
+    void                                write( const float *samples, int sampleCount );
+    void                                restart( double startTime );
+    void                                stop();
+
+    int                                 getDroppedFrameCount() const;
+
+protected:
+    void                                run();
+
+private:
+    struct                              Block {
+        QVector<float>                  samples;
+        int                             sampleCount;
+        bool                            restart;            //the detection starts over at startTime with this block
+        double                          startTime;
+    };
+
+    //a DSP callback every 10 ms or so fills a block, the ring holds a few seconds of them
+    static const int                    BLOCK_FRAMES = 512;
+    static const int                    BLOCK_COUNT = 256;
+
+    int                                 frequency;
+    int                                 channels;
+    OnlineOnsetDetector                 detector;
+    OnlineOnsetDetector::Listener       *listener;
+    SpscRing<Block>                     blocks;
+    QSemaphore                          writtenBlocks;      //released per block written and once by stop()
+    QAtomicInt                          stopped;
+
+    DWORD                               channel;
+    HDSP                                dsp;
+
+    //writer side, a restart asked for by another thread is taken up by the next write()
+    QAtomicInt                          restartRequested;
+    QAtomicInteger<qint64>              requestedStartFrame;
+    qint64                              writerStartFrame;
+    qint64                              writtenFrames;
+    bool                                discontinuous;
+    QAtomicInt                          droppedFrames;
+
+    //reader side
+    double                              startTime;
+
+    void                                onsetDetected( double time, float strength );
+    void                                levelMeasured( double time, float rms );
+
+    static void CALLBACK                processDsp( HDSP handle, DWORD channel, void *buffer, DWORD length, void *user );
+};
+
+#endif // LIVETAP_H
@@ -0,0 +1,220 @@
+#include "onlineonsetdetector.h"
+
+OnlineOnsetDetector::OnlineOnsetDetector( int frequency, int channels, int lookahead, bool window ) :
+    frequency( frequency ),
+    channels( qMax( 1, channels ) ),
+    frameSize( 1024 ),
+    hopSize( 2048 ),
+    window( window ),
+    listener( 0 ),
+    ONSET_THRESHOLD_WINDOW_SIZE( 20 ), ONSET_MULTIPLIER( 1.5 ), ONSET_LOOKAHEAD( qMax( 0, lookahead ) ),
+    ONSET_PEAK_PRE_WINDOW( 0 ), ONSET_PEAK_POST_WINDOW( 1 ), ONSET_PEAK_MIN_INTERVAL( 0 ),
+    ONSET_FUNCTION( AudioAnalysis::DETECTION_FUNCTION_FLUX ),
+    extractor( frequency, channels, frameSize, hopSize, window ) {
+
+    this->reset();
+}
+
+void OnlineOnsetDetector::setListener( Listener *listener ) {
+    this->listener = listener;
+}
+
+//options size the rings, so they start the detection over
+void OnlineOnsetDetector::setOnsetOptions( int thresholdWindowSize, float onsetMultiplier ) {
+    if ( thresholdWindowSize < 1 || onsetMultiplier < 1.0 || onsetMultiplier > 2.0 ) {
+        return;
+    }
+    ONSET_THRESHOLD_WINDOW_SIZE = thresholdWindowSize;
+    ONSET_MULTIPLIER = onsetMultiplier;
+    this->reset();
+}
+
+void OnlineOnsetDetector::setPeakOptions( int preWindow, int postWindow, int minInterval ) {
+    ONSET_PEAK_PRE_WINDOW = qBound( 0, preWindow, AudioAnalysis::MAX_PEAK_WINDOW );
+    ONSET_PEAK_POST_WINDOW = qBound( 0, postWindow, AudioAnalysis::MAX_PEAK_WINDOW );
+    ONSET_PEAK_MIN_INTERVAL = qBound( 0, minInterval, AudioAnalysis::MAX_PEAK_MIN_INTERVAL );
+    this->reset();
+}
+
+void OnlineOnsetDetector::setDetectionFunction( AudioAnalysis::DETECTION_FUNCTION detectionFunction ) {
+    ONSET_FUNCTION = detectionFunction;
+    this->reset();
+}
+
+void OnlineOnsetDetector::reset() {
+    extractor.reset();
+
+    history.fill( 0.0, frameSize );
+    frame.fill( 0.0, frameSize );
+    position = 0;
+    nextFrameStart = 0;
+    frameCount = 0;
+
+    hopSquares = 0.0;
+    hopSamples = 0;
+    hopCount = 0;
+
+    detections.fill( 0.0, ONSET_THRESHOLD_WINDOW_SIZE + this->getLookahead() + 1 );
+    detectionCount = 0;
+    thresholded.fill( 0.0, ONSET_PEAK_PRE_WINDOW + ONSET_PEAK_POST_WINDOW + 1 );
+    thresholdedCount = 0;
+    decidedCount = 0;
+    lastPeak = -ONSET_PEAK_MIN_INTERVAL - 1;
+}
+
+//detection value i needs frame i + 1, its threshold lookahead more, its peak decision postWindow more,
+//and the last of those frames ends frameSize samples after it starts
+int OnlineOnsetDetector::getLatency() const {
+    return ( 1 + this->getLookahead() + ONSET_PEAK_POST_WINDOW ) * hopSize + frameSize;
+}
+
+double OnlineOnsetDetector::getLatencySeconds() const {
+    return ( double ) this->getLatency() / frequency;
+}
+
+//a lookahead beyond the threshold window wouldn't be used by the offline detection either
+int OnlineOnsetDetector::getLookahead() const {
+    return qMin( ONSET_LOOKAHEAD, ONSET_THRESHOLD_WINDOW_SIZE );
+}
+
+//allocates nothing, listeners are called before it returns
+void OnlineOnsetDetector::push( const float *samples, int frameCount ) {
+    for ( int f = 0 ; f < frameCount ; f++ ) {
+        const float *sampleFrame = samples + f * channels;
+
+        //the same mono mix and hop level as FeatureExtractor
+        float mono = 0.0;
+        for ( int c = 0 ; c < channels ; c++ ) {
+            float value = sampleFrame[c];
+            hopSquares += value * value;
+            mono += value;
+        }
+        mono /= channels;
+
+        history[position % frameSize] = mono;
+        position++;
+
+        if ( ++hopSamples == hopSize ) {
+            this->finishHop();
+        }
+        if ( nextFrameStart + frameSize <= position ) {
+            for ( int i = 0 ; i < frameSize ; i++ ) {
+                frame[i] = history[( nextFrameStart + i ) % frameSize];
+            }
+            this->processFrame();
+        }
+    }
+}
+
+//the end of the input: zero padded last frames like the offline analysis,
+//then the values which were waiting for their lookahead
+void OnlineOnsetDetector::finish() {
+    if ( hopSamples > 0 ) {
+        this->finishHop();
+    }
+
+    while ( nextFrameStart < position ) {
+        for ( int i = 0 ; i < frameSize ; i++ ) {
+            qint64 p = nextFrameStart + i;
+            frame[i] = p < position ? history[p % frameSize] : 0.0;
+        }
+        this->processFrame();
+    }
+
+    qint64 last = detectionCount - 1;
+    for ( qint64 i = thresholdedCount ; i <= last ; i++ ) {
+        this->addThresholded( i, qMin( last, i + this->getLookahead() ) );
+    }
+    for ( qint64 i = decidedCount ; i <= last ; i++ ) {
+        this->decide( i, last );
+    }
+}
+
+void OnlineOnsetDetector::finishHop() {
+    if ( listener ) {
+        float rms = qSqrt( hopSquares / ( ( double ) hopSamples * channels ) );
+        listener->levelMeasured( ( double ) hopCount * hopSize / frequency, rms );
+    }
+
+    hopSquares = 0.0;
+    hopSamples = 0;
+    hopCount++;
+}
+
+//the first frame has nothing to rise from and isn't part of the detection function
+void OnlineOnsetDetector::processFrame() {
+    float values[FeatureExtractor::FEATURE_COUNT];
+    extractor.analyseFrame( frame.constData(), values );
+    nextFrameStart += hopSize;
+
+    if ( frameCount++ == 0 ) {
+        return;
+    }
+    this->addDetection( ONSET_FUNCTION == AudioAnalysis::DETECTION_FUNCTION_SUPERFLUX ?
+                        values[FeatureExtractor::FEATURE_SUPERFLUX] : values[FeatureExtractor::FEATURE_FLUX] );
+}
+
+void OnlineOnsetDetector::addDetection( float value ) {
+    detections[detectionCount % detections.size()] = value;
+    detectionCount++;
+
+    qint64 i = detectionCount - 1 - this->getLookahead();
+    if ( i >= 0 ) {
+        this->addThresholded( i, detectionCount - 1 );
+    }
+}
+
+//Transform::subtractThreshold() with the window ending at stop, summed in the same order
+void OnlineOnsetDetector::addThresholded( qint64 i, qint64 stop ) {
+    int size = detections.size();
+    qint64 start = qMax( ( qint64 ) 0, i - ONSET_THRESHOLD_WINDOW_SIZE );
+    float x = detections[i % size];
+
+    float value = 0.0;
+    if ( stop > start ) {
+        float mean = 0;
+        for ( qint64 j = start ; j <= stop ; j++ ) {
+            mean += detections[j % size];
+        }
+        mean /= ( stop - start );
+        float threshold = mean * ONSET_MULTIPLIER;
+        value = threshold <= x ? x - threshold : 0.0;
+    }
+
+    thresholded[i % thresholded.size()] = value;
+    thresholdedCount = i + 1;
+
+    qint64 decision = i - ONSET_PEAK_POST_WINDOW;
+    if ( decision >= 0 ) {
+        this->decide( decision, -1 );
+    }
+}
+
+//Transform::pickPeaks() of value i, last is the final index once the input ended, -1 before
+void OnlineOnsetDetector::decide( qint64 i, qint64 last ) {
+    int size = thresholded.size();
+    float x = thresholded[i % size];
+    decidedCount = i + 1;
+
+    float before = x;
+    for ( qint64 j = qMax( ( qint64 ) 0, i - ONSET_PEAK_PRE_WINDOW ) ; j < i ; j++ ) {
+        before = qMax( before, thresholded[j % size] );
+    }
+
+    bool beyondPost = ONSET_PEAK_POST_WINDOW == 0 || i == last;
+    float after = 0.0;
+    if ( !beyondPost ) {
+        qint64 stop = last >= 0 ? qMin( last, i + ONSET_PEAK_POST_WINDOW ) : i + ONSET_PEAK_POST_WINDOW;
+        after = thresholded[( i + 1 ) % size];
+        for ( qint64 j = i + 2 ; j <= stop ; j++ ) {
+            after = qMax( after, thresholded[j % size] );
+        }
+    }
+
+    if ( x > 0.0 && x >= before && ( beyondPost || x > after ) && i - lastPeak > ONSET_PEAK_MIN_INTERVAL ) {
+        lastPeak = i;
+        if ( listener ) {
+            listener->onsetDetected( ( double ) i * hopSize / frequency, x );
+        }
+    }
+}
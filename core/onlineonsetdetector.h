@@ -0,0 +1,84 @@
+#ifndef ONLINEONSETDETECTOR_H
+#define ONLINEONSETDETECTOR_H
+
+#include <QVector>
+#include "audioanalysis.h"
+#include "featureextractor.h"
+
+//onsets of samples pushed as they arrive, like live input; the detection of AudioAnalysis
+//with a threshold window reaching at most lookahead frames ahead instead of thresholdWindowSize,
+//with lookahead = thresholdWindowSize it finds the offline onsets.
+//strengths aren't normalised to the track's maximum, which isn't known yet.
+//every onset is reported at most getLatency() sample frames after its time
+class OnlineOnsetDetector {
+
+public:
+    //called from the pushing thread
+    class                               Listener {
+
+    public:
+        virtual                         ~Listener() {}
+        virtual void                    onsetDetected( double time, float strength ) = 0;
+        virtual void                    levelMeasured( double time, float rms ) = 0;
+    };
+
+                                        OnlineOnsetDetector( int frequency, int channels, int lookahead = 2, bool window = true );
+
+    void                                setListener( Listener *listener );
+    void                                setOnsetOptions( int thresholdWindowSize, float onsetMultiplier );
+    void                                setPeakOptions( int preWindow, int postWindow, int minInterval );
+    void                                setDetectionFunction( AudioAnalysis::DETECTION_FUNCTION detectionFunction );
+
+    void                                push( const float *samples, int frameCount );
+    void                                finish();
+    void                                reset();
+
+    int                                 getLatency() const;
+    double                              getLatencySeconds() const;
+
+private:
+    int                                 frequency;
+    int                                 channels;
+    int                                 frameSize;
+    int                                 hopSize;
+    bool                                window;
+    Listener                            *listener;
+
+    int                                 ONSET_THRESHOLD_WINDOW_SIZE;
+    double                              ONSET_MULTIPLIER;
+    int                                 ONSET_LOOKAHEAD;
+    int                                 ONSET_PEAK_PRE_WINDOW;
+    int                                 ONSET_PEAK_POST_WINDOW;
+    int                                 ONSET_PEAK_MIN_INTERVAL;
+    AudioAnalysis::DETECTION_FUNCTION   ONSET_FUNCTION;
+
+    FeatureExtractor                    extractor;
+
+    //last frameSize mono samples, sample p at p % frameSize
+    QVector<float>                      history;
+    QVector<float>                      frame;
+    qint64                              position;
+    qint64                              nextFrameStart;
+    int                                 frameCount;
+
+    double                              hopSquares;
+    int                                 hopSamples;
+    qint64                              hopCount;
+
+    //rings of the detection function and of it minus the threshold, value i at i % size
+    QVector<float>                      detections;
+    qint64                              detectionCount;
+    QVector<float>                      thresholded;
+    qint64                              thresholdedCount;
+    qint64                              decidedCount;
+    qint64                              lastPeak;
+
+    int                                 getLookahead() const;
+    void                                finishHop();
+    void                                processFrame();
+    void                                addDetection( float value );
+    void                                addThresholded( qint64 i, qint64 stop );
+    void                                decide( qint64 i, qint64 last );
+};
+
+#endif // ONLINEONSETDETECTOR_H
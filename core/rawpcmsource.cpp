@@ -0,0 +1,47 @@
+#include "rawpcmsource.h"
+#include <QtEndian>
+#include <cstring>
+
+RawPcmSource::RawPcmSource( QIODevice *device, SAMPLE_FORMAT sampleFormat ) :
+    device( device ), sampleFormat( sampleFormat ) {
+}
+
+int RawPcmSource::getSampleSize( SAMPLE_FORMAT sampleFormat ) {
+    return sampleFormat == SAMPLE_FORMAT_INT16 ? 2 : 4;
+}
+
+//a pipe hands out what's there, so reads go on until the request is filled or the device ends
+int RawPcmSource::read( float *samples, int maxSampleCount ) {
+    int sampleSize = getSampleSize( sampleFormat );
+    qint64 wanted = ( qint64 ) maxSampleCount * sampleSize;
+    if ( buffer.size() < wanted ) {
+        buffer.resize( wanted );
+    }
+
+    qint64 filled = 0;
+    while ( filled < wanted ) {
+        qint64 bytes = device->read( buffer.data() + filled, wanted - filled );
+        if ( bytes > 0 ) {
+            filled += bytes;
+            continue;
+        }
+        if ( bytes < 0 || !device->waitForReadyRead( -1 ) ) {
+            break;
+        }
+    }
+
+    //a trailing partial sample is dropped
+    int sampleCount = filled / sampleSize;
+    const uchar *data = ( const uchar * ) buffer.constData();
+    if ( sampleFormat == SAMPLE_FORMAT_INT16 ) {
+        for ( int i = 0 ; i < sampleCount ; i++ ) {
+            samples[i] = qFromLittleEndian<qint16>( data + 2 * i ) / 32768.0f;
+        }
+    } else {
+        for ( int i = 0 ; i < sampleCount ; i++ ) {
+            quint32 bits = qFromLittleEndian<quint32>( data + 4 * i );
+            memcpy( samples + i, &bits, sizeof( float ) );
+        }
+    }
+    return sampleCount;
+}
@@ -0,0 +1,30 @@
+#ifndef RAWPCMSOURCE_H
+#define RAWPCMSOURCE_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include "audiosource.h"
+
+//headerless interleaved little endian pcm from a device, like stdin or a socket,
+//read as it arrives so nothing goes through a temporary file
+class RawPcmSource : public AudioSource {
+
+public:
+    enum                                SAMPLE_FORMAT {
+        SAMPLE_FORMAT_FLOAT32,
+        SAMPLE_FORMAT_INT16
+    };
+
+                                        RawPcmSource( QIODevice *device, SAMPLE_FORMAT sampleFormat );
+
+    int                                 read( float *samples, int maxSampleCount );
+
+    static int                          getSampleSize( SAMPLE_FORMAT sampleFormat );
+
+private:
+    QIODevice                           *device;
+    SAMPLE_FORMAT                       sampleFormat;
+    QByteArray                          buffer;
+};
+
+#endif // RAWPCMSOURCE_H
@@ -0,0 +1,151 @@
+#include "segmentedfeatureextractor.h"
+#include <QRunnable>
+#include <cstring>
+
+class SegmentJob : public QRunnable {
+
+public:
+                                        SegmentJob( SegmentedFeatureExtractor *extractor, SegmentedFeatureExtractor::Segment *segment ) :
+        extractor( extractor ), segment( segment ) {}
+
+    void                                run() {
+        SegmentedFeatureExtractor::analyseSegment( segment, extractor->frequency, extractor->channels,
+                extractor->frameSize, extractor->hopSize, extractor->window );
+        extractor->queueSlots.release();
+        extractor->finishedSegments.release();
+    }
+
+private:
+    SegmentedFeatureExtractor           *extractor;
+    SegmentedFeatureExtractor::Segment  *segment;
+};
+
+SegmentedFeatureExtractor::SegmentedFeatureExtractor( int frequency, int channels, int frameSize, int hopSize, bool window,
+        int segmentHops, QThreadPool *pool ) :
+    frequency( frequency ),
+    channels( qMax( 1, channels ) ),
+    frameSize( 2 ),
+    hopSize( qMax( 1, hopSize ) ),
+    window( window ),
+    segmentHops( qMax( 1, segmentHops ) ),
+    pool( pool ? pool : QThreadPool::globalInstance() ),
+    bufferStart( 0 ),
+    nextFirstFrame( 0 ),
+    finished( false ),
+    queueSlots( 2 * qMax( 1, this->pool->maxThreadCount() ) ),
+    finishedSegments( 0 ) {
+
+    //rounded up the way FeatureExtractor does
+    while ( this->frameSize < frameSize ) {
+        this->frameSize *= 2;
+    }
+}
+
+//segments still queued refer to this
+SegmentedFeatureExtractor::~SegmentedFeatureExtractor() {
+    finishedSegments.acquire( segments.size() );
+    qDeleteAll( segments );
+}
+
+//the hop before the first frame, for the previous spectrum of flux
+qint64 SegmentedFeatureExtractor::getSegmentStart( int firstFrame ) const {
+    return ( qint64 ) qMax( 0, firstFrame - 1 ) * hopSize;
+}
+
+//the last frame's spectrum and its hop are both complete there
+qint64 SegmentedFeatureExtractor::getSegmentEnd( int firstFrame ) const {
+    qint64 lastFrameStart = ( qint64 ) ( firstFrame + segmentHops - 1 ) * hopSize;
+    return lastFrameStart + qMax( frameSize, hopSize );
+}
+
+void SegmentedFeatureExtractor::push( const float *samples, int frameCount ) {
+    int size = buffer.size();
+    buffer.resize( size + frameCount * channels );
+    memcpy( buffer.data() + size, samples, frameCount * channels * sizeof( float ) );
+
+    qint64 bufferEnd = bufferStart + buffer.size() / channels;
+    while ( getSegmentEnd( nextFirstFrame ) <= bufferEnd ) {
+        int firstFrame = nextFirstFrame;
+        this->startSegment( firstFrame, getSegmentEnd( firstFrame ), false );
+        nextFirstFrame += segmentHops;
+
+        //the next segment starts a hop before its first frame, inside this one
+        qint64 drop = getSegmentStart( nextFirstFrame ) - bufferStart;
+        buffer.remove( 0, drop * channels );
+        bufferStart += drop;
+    }
+}
+
+//copies [segment start, end) so the buffer can move on while the segment is analysed
+void SegmentedFeatureExtractor::startSegment( int firstFrame, qint64 end, bool last ) {
+    Segment *segment = new Segment();
+    segment->firstFrame = firstFrame;
+    segment->frameCount = last ? -1 : segmentHops;
+    segment->last = last;
+
+    qint64 start = getSegmentStart( firstFrame );
+    segment->samples = buffer.mid( ( start - bufferStart ) * channels, ( end - start ) * channels );
+    segments.append( segment );
+
+    //bounded, decoding doesn't run away from the pool with the whole track in memory
+    queueSlots.acquire();
+    pool->start( new SegmentJob( this, segment ) );
+}
+
+//the rest of the buffer is the last segment, frames running past the end are padded there
+void SegmentedFeatureExtractor::finish() {
+    if ( finished ) {
+        return;
+    }
+    finished = true;
+
+    this->startSegment( nextFirstFrame, bufferStart + buffer.size() / channels, true );
+    buffer.clear();
+
+    finishedSegments.acquire( segments.size() );
+    this->stitch();
+}
+
+void SegmentedFeatureExtractor::analyseSegment( Segment *segment, int frequency, int channels, int frameSize, int hopSize, bool window ) {
+    FeatureExtractor extractor( frequency, channels, frameSize, hopSize, window );
+    extractor.push( segment->samples.constData(), segment->samples.size() / channels );
+    if ( segment->last ) {
+        extractor.finish();
+    }
+    segment->samples.clear();
+
+    //the lead-in frame only served as the previous spectrum
+    int skip = segment->firstFrame > 0 ? 1 : 0;
+    for ( int f = 0 ; f < FeatureExtractor::FEATURE_COUNT ; f++ ) {
+        const QVector<float> &column = extractor.getFeature( ( FeatureExtractor::FEATURE ) f );
+        int count = segment->last ? column.size() - skip : segment->frameCount;
+        segment->features[f] = column.mid( skip, qMax( 0, count ) );
+    }
+}
+
+void SegmentedFeatureExtractor::stitch() {
+    for ( int s = 0 ; s < segments.size() ; s++ ) {
+        Segment *segment = segments.at( s );
+        for ( int f = 0 ; f < FeatureExtractor::FEATURE_COUNT ; f++ ) {
+            features[f] += segment->features[f];
+        }
+        delete segment;
+    }
+    segments.clear();
+}
+
+int SegmentedFeatureExtractor::getFrameCount() const {
+    return features[FeatureExtractor::FEATURE_FLUX].size();
+}
+
+int SegmentedFeatureExtractor::getFrameSize() const {
+    return frameSize;
+}
+
+int SegmentedFeatureExtractor::getHopSize() const {
+    return hopSize;
+}
+
+const QVector<float> &SegmentedFeatureExtractor::getFeature( FeatureExtractor::FEATURE feature ) const {
+    return features[feature];
+}
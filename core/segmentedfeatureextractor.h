@@ -0,0 +1,67 @@
+#ifndef SEGMENTEDFEATUREEXTRACTOR_H
+#define SEGMENTEDFEATUREEXTRACTOR_H
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QVector>
+#include "featureextractor.h"
+
+//FeatureExtractor over segments of segmentHops frames analysed on a thread pool while decoding goes on.
+//a segment starts a hop before its first frame, so flux has the previous spectrum, and runs until its
+//last frame and hop are complete; frames depend on nothing else, the stitched columns are
+//the same as pushing everything into one FeatureExtractor
+class SegmentedFeatureExtractor {
+
+public:
+                                        SegmentedFeatureExtractor( int frequency, int channels, int frameSize = 1024, int hopSize = 2048, bool window = true,
+                                                                   int segmentHops = 256, QThreadPool *pool = 0 );
+                                        ~SegmentedFeatureExtractor();
+
+    void                                push( const float *samples, int frameCount );
+    void                                finish();
+
+    int                                 getFrameCount() const;
+    int                                 getFrameSize() const;
+    int                                 getHopSize() const;
+    const QVector<float>                &getFeature( FeatureExtractor::FEATURE feature ) const;
+
+private:
+    struct                              Segment {
+        int                             firstFrame;
+        int                             frameCount;     //-1 for the last segment, it keeps everything
+        bool                            last;
+        QVector<float>                  samples;
+        QVector<float>                  features[FeatureExtractor::FEATURE_COUNT];
+    };
+
+    int                                 frequency;
+    int                                 channels;
+    int                                 frameSize;
+    int                                 hopSize;
+    bool                                window;
+    int                                 segmentHops;
+    QThreadPool                         *pool;
+
+    //interleaved samples from sample frame bufferStart on
+    QVector<float>                      buffer;
+    qint64                              bufferStart;
+    int                                 nextFirstFrame;
+    bool                                finished;
+
+    QVector<Segment *>                  segments;
+    QSemaphore                          queueSlots;
+    QSemaphore                          finishedSegments;
+
+    QVector<float>                      features[FeatureExtractor::FEATURE_COUNT];
+
+    qint64                              getSegmentStart( int firstFrame ) const;
+    qint64                              getSegmentEnd( int firstFrame ) const;
+    void                                startSegment( int firstFrame, qint64 end, bool last );
+    void                                stitch();
+
+    static void                         analyseSegment( Segment *segment, int frequency, int channels, int frameSize, int hopSize, bool window );
+
+    friend class                        SegmentJob;
+};
+
+#endif // SEGMENTEDFEATUREEXTRACTOR_H
@@ -0,0 +1,73 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <QAtomicInteger>
+#include <QVector>
+
+//bounded ring of preallocated slots between one producer and one consumer thread.
+//the producer fills the slot from beginWrite() and publishes it with endWrite(),
+//the consumer reads the slot from beginRead() and hands it back with endRead();
+//both sides return 0 instead of waiting, neither takes a lock
+template<class T>
+class SpscRing {
+
+public:
+    explicit                            SpscRing( int capacity ) :
+        head( 0 ), tail( 0 ) {
+
+        int size = 2;
+        while ( size < capacity ) {
+            size *= 2;
+        }
+        items.resize( size );
+        itemData = items.data();
+        mask = size - 1;
+    }
+
+    int                                 getCapacity() const {
+        return items.size();
+    }
+
+    //slots for setting up buffers before the threads start
+    T                                   &at( int index ) {
+        return itemData[index];
+    }
+
+    T                                   *beginWrite() {
+        quint32 t = tail.load();
+        if ( t - head.loadAcquire() == ( quint32 ) items.size() ) {
+            return 0;
+        }
+        return &itemData[t & mask];
+    }
+
+    void                                endWrite() {
+        tail.storeRelease( tail.load() + 1 );
+    }
+
+    T                                   *beginRead() {
+        quint32 h = head.load();
+        if ( h == tail.loadAcquire() ) {
+            return 0;
+        }
+        return &itemData[h & mask];
+    }
+
+    void                                endRead() {
+        head.storeRelease( head.load() + 1 );
+    }
+
+private:
+    //both threads index the buffer taken once here, QVector's non-const operator[] would check for detaching
+    QVector<T>                          items;
+    T                                   *itemData;
+    int                                 mask;
+
+    //free running counters, each written by one side only, wrapping is fine;
+    //kept apart so they don't share a cache line
+    QAtomicInteger<quint32>             head;
+    char                                padding[64];
+    QAtomicInteger<quint32>             tail;
+};
+
+#endif // SPSCRING_H
@@ -0,0 +1,347 @@
+#include "transform.h"
+#include <QRunnable>
+#include <QSemaphore>
+
+//thresholds values [begin, end) of a segment, reading window values to either side
+class ThresholdJob : public QRunnable {
+
+public:
+                                        ThresholdJob( const QVector<float> &values, QVector<float> &result, int begin, int end,
+                                                      int window, double multiplier, QSemaphore *done ) :
+        values( values ), result( result ), begin( begin ), end( end ), window( window ), multiplier( multiplier ), done( done ) {}
+
+    void                                run() {
+        int N = values.size();
+        const float *x = values.constData();
+        float *y = result.data();
+        for ( int i = begin ; i < end ; i++ ) {
+            int start = qMax( 0, i - window );
+            int stop = qMin( N - 1, i + window );
+            float mean = 0;
+            for ( int j = start ; j <= stop ; j++ ) {
+                mean += x[j];
+            }
+            mean /= ( stop - start );
+            float threshold = mean * multiplier;
+            y[i] = threshold <= x[i] ? x[i] - threshold : 0.0;
+        }
+        done->release();
+    }
+
+private:
+    const QVector<float>                &values;
+    QVector<float>                      &result;
+    int                                 begin;
+    int                                 end;
+    int                                 window;
+    double                              multiplier;
+    QSemaphore                          *done;
+};
+
+QVector<float> Transform::correlateDFT( const QVector<float> &pcmBlock ) {
+    int N = pcmBlock.length(); //must be a power of 2
+
+    QVector<float> re( ( N / 2 ) + 1 );
+    QVector<float> im( ( N / 2 ) + 1 );
+    re.fill( 0.0 );
+    im.fill( 0.0 );
+
+    for ( int k = 0 ; k < ( N / 2 ) + 1 ; k++ ) {
+        for ( int i = 0 ; i < N ; i++ ) {
+            re[k] += pcmBlock[i] * qCos( 2 * M_PI * k * i / N );
+            im[k] += pcmBlock[i] * -qSin( 2 * M_PI * k * i / N );
+        }
+    }
+
+    //polar
+    QVector<float> mag( ( N / 2 ) + 1 );
+
+    for ( int k = 0 ; k < ( N / 2 ) + 1 ; k++ ) {
+        mag[k] = qSqrt( re[k] * re[k] + im[k] * im[k] );
+        if ( re[k] == 0.0 ) {
+            re[k] = 1e-20;
+        }
+    }
+
+    return mag;
+}
+
+QVector<float> Transform::FFT( const QVector<float> &pcmBlock ) {
+    int N = pcmBlock.length();
+    if ( N <= 1 ) {
+        return pcmBlock;
+    }
+
+    std::valarray< std::complex<float> > x( N );
+    for ( int i = 0 ; i < pcmBlock.size() ; i++ ) {
+        x[i] = pcmBlock.at( i );
+    }
+
+    FFT( x );
+
+    QVector<float> mag( ( N / 2 ) + 1 );
+
+    for ( int k = 0 ; k < ( N / 2 ) + 1 ; k++ ) {
+        mag[k] = qSqrt( x[k].real() * x[k].real() + x[k].imag() * x[k].imag() );
+        if ( x[k].real() == 0.0 ) {
+            x[k].real( 1e-20 );
+        }
+    }
+
+    return mag;
+}
+
+void Transform::FFT( std::valarray< std::complex<float> > &x ) {
+    int N = x.size();
+    if ( N <= 1 ) {
+        return;
+    }
+
+    std::valarray< std::complex<float> > even = x[ std::slice( 0, N / 2, 2 ) ];
+    std::valarray< std::complex<float> > odd = x[ std::slice( 1, N / 2, 2 ) ];
+
+    FFT( even );
+    FFT( odd );
+
+    for ( int k = 0 ; k < N / 2 ; k++ ) {
+        std::complex<float> t = ( std::complex<float> ) std::polar( 1.0, -2 * M_PI * k / N ) * odd[k];
+        x[k] = even[k] + t;
+        x[k + N / 2] = even[k] - t;
+    }
+}
+
+float Transform::getSpectrumFlux( QVector<float> &pcmBlock, QVector<float> &nextPcmBlock ) {
+
+    pcmBlock = FFT( pcmBlock );
+    nextPcmBlock = FFT( nextPcmBlock );
+
+    //hamming
+    hamming( pcmBlock );
+    hamming( nextPcmBlock );
+
+    float flux = 0.0;
+    for ( int i = 0 ; i < nextPcmBlock.length() ; i++ ) {
+        float value = nextPcmBlock.at( i ) - pcmBlock.at( i );
+        flux += value < 0 ? 0 : value;
+    }
+
+    return flux;
+}
+
+float Transform::getSpectrumFlux( float *block, float *nextBlock, int size ) {
+    float flux = 0.0;
+    for ( int i = 0 ; i < size ; i++ ) {
+        float value = nextBlock[i] - block[i];
+        flux += value < 0 ? 0 : value;
+    }
+
+    return flux;
+}
+
+void Transform::hamming( QVector<float> &pcmBlock ) {
+    for ( int i = 0 ; i < pcmBlock.length() ; i++ ) {
+        pcmBlock[i] *= ( 0.54f - 0.46f * qCos( 2 * M_PI * i / ( pcmBlock.length() - 1 ) ) );
+    }
+}
+
+
+//squarePrefixSums[i] is the sum of squares of samples [0, i)
+QVector<double> Transform::getSquarePrefixSums( const QVector<float> &samples ) {
+    int N = samples.length();
+
+    //squaring has no dependency between samples, kept apart from the sum so it vectorizes
+    QVector<float> squares( N );
+    const float *x = samples.constData();
+    float *x2 = squares.data();
+    for ( int i = 0 ; i < N ; i++ ) {
+        x2[i] = x[i] * x[i];
+    }
+
+    QVector<double> prefixSums( N + 1 );
+    double *sums = prefixSums.data();
+    sums[0] = 0.0;
+    for ( int i = 0 ; i < N ; i++ ) {
+        sums[i + 1] = sums[i] + x2[i];
+    }
+
+    return prefixSums;
+}
+
+//rms over [i - window, i + window] for every sample in O(N), whatever the window,
+//divided by the distance between the ends like the stress envelope always was
+QVector<float> Transform::getSlidingRMS( const QVector<double> &squarePrefixSums, int window ) {
+    int N = squarePrefixSums.length() - 1;
+    if ( N <= 0 ) {
+        return QVector<float>();
+    }
+
+    QVector<float> rms( N );
+    const double *sums = squarePrefixSums.constData();
+    for ( int i = 0 ; i < N ; i++ ) {
+        int start = qMax( 0, i - window );
+        int end = qMin( N - 1, i + window );
+        double mean = ( sums[end + 1] - sums[start] ) / qMax( 1, end - start );
+        rms[i] = qSqrt( mean );
+    }
+
+    return rms;
+}
+
+//van Herk/Gil-Werman: maxima[i] is the max of values [i, i + window), clipped at the end,
+//three comparisons per value whatever the window
+void Transform::slidingMax( const float *values, int count, int window, float *maxima ) {
+    if ( count <= 0 || window <= 0 ) {
+        return;
+    }
+
+    QVector<float> prefix( count );
+    QVector<float> suffix( count );
+    slidingMax( values, count, window, maxima, prefix.data(), suffix.data() );
+}
+
+//the same with caller owned scratch of count values each, for callers running it per frame
+void Transform::slidingMax( const float *values, int count, int window, float *maxima, float *prefix, float *suffix ) {
+    if ( count <= 0 || window <= 0 ) {
+        return;
+    }
+
+    //prefix maxima from the start of every window-sized block, suffix maxima to its end
+    float *g = prefix;
+    float *h = suffix;
+
+    for ( int i = 0 ; i < count ; i++ ) {
+        g[i] = i % window == 0 ? values[i] : qMax( g[i - 1], values[i] );
+    }
+    for ( int i = count - 1 ; i >= 0 ; i-- ) {
+        h[i] = ( i % window == window - 1 || i == count - 1 ) ? values[i] : qMax( h[i + 1], values[i] );
+    }
+
+    //a window starting at i covers the rest of i's block and the beginning of the next one
+    int full = qMax( 0, count - window + 1 );
+    for ( int i = 0 ; i < full ; i++ ) {
+        maxima[i] = qMax( h[i], g[i + window - 1] );
+    }
+    for ( int i = full ; i < count ; i++ ) {
+        maxima[i] = i / window == ( count - 1 ) / window ? h[i] : qMax( h[i], g[count - 1] );
+    }
+}
+
+//keeps what's above multiplier times the mean of the window values to either side, 0 elsewhere;
+//segments are independent, each one only reads the values around it
+void Transform::subtractThreshold( QVector<float> &values, int window, double multiplier, QThreadPool *pool ) {
+    int N = values.size();
+    if ( N <= 0 ) {
+        return;
+    }
+
+    const int SEGMENT_SIZE = 16384;
+    QVector<float> result( N );
+    QSemaphore done( 0 );
+    int segmentCount = 0;
+    for ( int begin = 0 ; begin < N ; begin += SEGMENT_SIZE ) {
+        ThresholdJob *job = new ThresholdJob( values, result, begin, qMin( N, begin + SEGMENT_SIZE ), window, multiplier, &done );
+        if ( pool ) {
+            pool->start( job );
+        } else {
+            job->run();
+            delete job;
+        }
+        segmentCount++;
+    }
+    done.acquire( segmentCount );
+
+    values.swap( result );
+}
+
+//mean of the functions each divided by its own mean, so no resolution dominates,
+//scaled back to the mean of the first one; functions are cut to the shortest
+QVector<float> Transform::fuseDetectionFunctions( const QVector< QVector<float> > &functions ) {
+    if ( functions.isEmpty() ) {
+        return QVector<float>();
+    }
+
+    int N = functions.at( 0 ).size();
+    for ( int r = 1 ; r < functions.size() ; r++ ) {
+        N = qMin( N, functions.at( r ).size() );
+    }
+
+    QVector<double> means( functions.size(), 0.0 );
+    for ( int r = 0 ; r < functions.size() ; r++ ) {
+        const float *x = functions.at( r ).constData();
+        for ( int i = 0 ; i < N ; i++ ) {
+            means[r] += x[i];
+        }
+        means[r] = N > 0 ? means[r] / N : 0.0;
+    }
+
+    QVector<float> fused( N, 0.0 );
+    float *y = fused.data();
+    for ( int r = 0 ; r < functions.size() ; r++ ) {
+        if ( means.at( r ) <= 0.0 ) {
+            continue;
+        }
+        const float *x = functions.at( r ).constData();
+        float scale = means.at( 0 ) / means.at( r ) / functions.size();
+        for ( int i = 0 ; i < N ; i++ ) {
+            y[i] += x[i] * scale;
+        }
+    }
+
+    return fused;
+}
+
+//keeps values which are the max of the preWindow values before them and greater than
+//the postWindow values after them, at least minInterval apart, and scales them by the largest one;
+//0, 1, 0 keeps every value greater than the next one
+QVector<float> Transform::pickPeaks( const QVector<float> &values, int preWindow, int postWindow, int minInterval ) {
+    int N = values.length();
+    QVector<float> peaks( N, 0.0 );
+    if ( N <= 0 ) {
+        return peaks;
+    }
+
+    preWindow = qMax( 0, preWindow );
+    postWindow = qMax( 0, postWindow );
+
+    //before[i] is the max of [i - preWindow, i], after[i] the max of [i + 1, i + postWindow]
+    QVector<float> before( N );
+    QVector<float> after( N );
+    QVector<float> maxima( N );
+    const float *x = values.constData();
+
+    slidingMax( x, N, preWindow + 1, maxima.data() );
+    for ( int i = 0 ; i < N ; i++ ) {
+        if ( i >= preWindow ) {
+            before[i] = maxima[i - preWindow];
+        } else {
+            before[i] = i == 0 ? x[0] : qMax( before[i - 1], x[i] );
+        }
+    }
+
+    if ( postWindow > 0 ) {
+        slidingMax( x, N, postWindow, maxima.data() );
+        for ( int i = 0 ; i < N - 1 ; i++ ) {
+            after[i] = maxima[i + 1];
+        }
+    }
+
+    float max = 0.0;
+    int lastPeak = -minInterval - 1;
+    for ( int i = 0 ; i < N ; i++ ) {
+        bool beyondPost = postWindow == 0 || i == N - 1;
+        if ( x[i] > 0.0 && x[i] >= before[i] && ( beyondPost || x[i] > after[i] ) && i - lastPeak > minInterval ) {
+            peaks[i] = x[i];
+            lastPeak = i;
+            max = qMax( max, x[i] );
+        }
+    }
+
+    if ( max > 0.0 ) {
+        float *p = peaks.data();
+        for ( int i = 0 ; i < N ; i++ ) {
+            p[i] /= max;
+        }
+    }
+
+    return peaks;
+}
@@ -0,0 +1,32 @@
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <QVector>
+#include <QDebug>
+#include "qmath.h"
+#include <complex>
+#include <valarray>
+#include <QElapsedTimer>
+#include <QThreadPool>
+
+class Transform {
+
+public:
+
+    static QVector<float>               correlateDFT( const QVector<float> &pcmBlock );
+    static QVector<float>               FFT( const QVector<float> &pcmBlock );
+    static void                         FFT(std::valarray<std::complex<float> > &x );
+    static float                        getSpectrumFlux( QVector<float> &pcmBlock , QVector<float> &nextPcmBlock );
+    static float                        getSpectrumFlux( float *block , float *nextBlock, int size = 256 );
+    static void                         hamming( QVector<float> &pcmBlock );
+    static QVector<double>              getSquarePrefixSums( const QVector<float> &samples );
+    static QVector<float>               getSlidingRMS( const QVector<double> &squarePrefixSums, int window );
+    static void                         slidingMax( const float *values, int count, int window, float *maxima );
+    static void                         slidingMax( const float *values, int count, int window, float *maxima, float *prefix, float *suffix );
+    static void                         subtractThreshold( QVector<float> &values, int window, double multiplier, QThreadPool *pool = 0 );
+    static QVector<float>               fuseDetectionFunctions( const QVector< QVector<float> > &functions );
+    static QVector<float>               pickPeaks( const QVector<float> &values, int preWindow = 0, int postWindow = 1, int minInterval = 0 );
+
+};
+
+#endif // TRANSFORM_H
@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# Checks of the analysis core against its offline
+# reference, run with make check
+#
+#-------------------------------------------------
+
+QT       = core testlib
+
+TARGET = tst_detection
+TEMPLATE = app
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+include(../core/core.pri)
+
+SOURCES += tst_detection.cpp
@@ -0,0 +1,184 @@
+#include "featureextractor.h"
+#include "onlineonsetdetector.h"
+#include "segmentedfeatureextractor.h"
+#include "transform.h"
+#include <QtTest>
+#include <random>
+
+//the streaming parts of the core have to give what the offline analysis gives,
+//whatever the sizes of the pieces the samples arrive in
+class TestDetection : public QObject {
+    Q_OBJECT
+
+private slots:
+    void                                onlineMatchesOffline_data();
+    void                                onlineMatchesOffline();
+    void                                segmentedMatchesSingle_data();
+    void                                segmentedMatchesSingle();
+};
+
+struct                                  RecordedOnset {
+    qint64                              index;
+    float                               strength;
+};
+
+class OnsetRecorder : public OnlineOnsetDetector::Listener {
+
+public:
+    QVector<RecordedOnset>              onsets;
+
+    OnsetRecorder( int frequency, int hopSize ) :
+        frequency( frequency ), hopSize( hopSize ) {}
+
+    void                                onsetDetected( double time, float strength ) {
+        RecordedOnset onset;
+        onset.index = qRound64( time * frequency / hopSize );
+        onset.strength = strength;
+        onsets.append( onset );
+    }
+
+    void                                levelMeasured( double time, float rms ) {
+        Q_UNUSED( time );
+        Q_UNUSED( rms );
+    }
+
+private:
+    int                                 frequency;
+    int                                 hopSize;
+};
+
+static const int FREQUENCY = 44100;
+static const int CHANNELS = 2;
+
+//noise with a loud burst every 19000 sample frames over a quiet tone, the same every run
+static QVector<float> makeSamples( int frameCount ) {
+    QVector<float> samples( frameCount * CHANNELS );
+    std::mt19937 generator( 7 );
+    std::normal_distribution<float> noise( 0.0, 0.1 );
+    for ( int i = 0 ; i < frameCount ; i++ ) {
+        float value = noise( generator ) * ( i % 19000 < 1500 ? 3.0 : 0.3 ) + 0.2 * qSin( i * 0.05 );
+        samples[i * CHANNELS] = value;
+        samples[i * CHANNELS + 1] = value * 0.7;
+    }
+    return samples;
+}
+
+void TestDetection::onlineMatchesOffline_data() {
+    QTest::addColumn<int>( "thresholdWindowSize" );
+    QTest::addColumn<int>( "preWindow" );
+    QTest::addColumn<int>( "postWindow" );
+    QTest::addColumn<int>( "minInterval" );
+    QTest::addColumn<bool>( "superFlux" );
+
+    QTest::newRow( "flux" ) << 20 << 0 << 1 << 0 << false;
+    QTest::newRow( "superflux" ) << 20 << 0 << 1 << 0 << true;
+    QTest::newRow( "peak windows" ) << 10 << 2 << 3 << 2 << false;
+    QTest::newRow( "no post window" ) << 5 << 0 << 0 << 0 << true;
+    QTest::newRow( "min interval" ) << 20 << 1 << 2 << 4 << false;
+}
+
+//with lookahead = thresholdWindowSize the online detection sees the offline threshold window;
+//its strengths aren't normalised, so they're compared relative to their maximum like pickPeaks() does
+void TestDetection::onlineMatchesOffline() {
+    QFETCH( int, thresholdWindowSize );
+    QFETCH( int, preWindow );
+    QFETCH( int, postWindow );
+    QFETCH( int, minInterval );
+    QFETCH( bool, superFlux );
+
+    int frameCount = FREQUENCY * 15;
+    QVector<float> samples = makeSamples( frameCount );
+    FeatureExtractor::FEATURE feature = superFlux ? FeatureExtractor::FEATURE_SUPERFLUX : FeatureExtractor::FEATURE_FLUX;
+
+    FeatureExtractor extractor( FREQUENCY, CHANNELS, 1024, 2048, true );
+    extractor.push( samples.constData(), frameCount );
+    extractor.finish();
+    QVector<float> values = extractor.getFeature( feature ).mid( 1 );
+    Transform::subtractThreshold( values, thresholdWindowSize, 1.5 );
+    QVector<float> peaks = Transform::pickPeaks( values, preWindow, postWindow, minInterval );
+
+    OnlineOnsetDetector detector( FREQUENCY, CHANNELS, thresholdWindowSize, true );
+    OnsetRecorder recorder( FREQUENCY, 2048 );
+    detector.setListener( &recorder );
+    detector.setOnsetOptions( thresholdWindowSize, 1.5 );
+    detector.setPeakOptions( preWindow, postWindow, minInterval );
+    detector.setDetectionFunction( superFlux ? AudioAnalysis::DETECTION_FUNCTION_SUPERFLUX : AudioAnalysis::DETECTION_FUNCTION_FLUX );
+
+    std::mt19937 generator( 3 );
+    std::uniform_int_distribution<int> chunkSize( 1, 5000 );
+    int pushed = 0;
+    while ( pushed < frameCount ) {
+        int count = qMin( frameCount - pushed, chunkSize( generator ) );
+        detector.push( samples.constData() + pushed * CHANNELS, count );
+        pushed += count;
+    }
+    detector.finish();
+
+    float maxStrength = 0.0;
+    for ( int i = 0 ; i < recorder.onsets.size() ; i++ ) {
+        maxStrength = qMax( maxStrength, recorder.onsets.at( i ).strength );
+    }
+
+    int onsetIndex = 0;
+    for ( int i = 0 ; i < peaks.size() ; i++ ) {
+        if ( peaks.at( i ) <= 0.0 ) {
+            continue;
+        }
+        QVERIFY2( onsetIndex < recorder.onsets.size(), "an offline onset wasn't detected online" );
+        const RecordedOnset &onset = recorder.onsets.at( onsetIndex++ );
+        QCOMPARE( onset.index, ( qint64 ) i );
+        QCOMPARE( onset.strength / maxStrength, peaks.at( i ) );
+    }
+    QVERIFY2( onsetIndex > 0, "the samples have no onsets" );
+    QCOMPARE( onsetIndex, recorder.onsets.size() );
+}
+
+void TestDetection::segmentedMatchesSingle_data() {
+    QTest::addColumn<int>( "frameSize" );
+    QTest::addColumn<int>( "hopSize" );
+    QTest::addColumn<int>( "segmentHops" );
+
+    QTest::newRow( "default" ) << 1024 << 2048 << 256;
+    QTest::newRow( "short segments" ) << 1024 << 2048 << 3;
+    QTest::newRow( "overlapping frames" ) << 4096 << 512 << 16;
+}
+
+//the stitched columns are bit-identical to one FeatureExtractor fed the same samples
+void TestDetection::segmentedMatchesSingle() {
+    QFETCH( int, frameSize );
+    QFETCH( int, hopSize );
+    QFETCH( int, segmentHops );
+
+    int frameCount = FREQUENCY * 10 + 777;
+    QVector<float> samples = makeSamples( frameCount );
+
+    FeatureExtractor single( FREQUENCY, CHANNELS, frameSize, hopSize, true );
+    single.push( samples.constData(), frameCount );
+    single.finish();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount( 4 );
+    SegmentedFeatureExtractor segmented( FREQUENCY, CHANNELS, frameSize, hopSize, true, segmentHops, &pool );
+    std::mt19937 generator( 5 );
+    std::uniform_int_distribution<int> chunkSize( 1, 8000 );
+    int pushed = 0;
+    while ( pushed < frameCount ) {
+        int count = qMin( frameCount - pushed, chunkSize( generator ) );
+        segmented.push( samples.constData() + pushed * CHANNELS, count );
+        pushed += count;
+    }
+    segmented.finish();
+
+    QCOMPARE( segmented.getFrameCount(), single.getFrameCount() );
+    for ( int feature = 0 ; feature < FeatureExtractor::FEATURE_COUNT ; feature++ ) {
+        const QVector<float> &expected = single.getFeature( ( FeatureExtractor::FEATURE ) feature );
+        const QVector<float> &actual = segmented.getFeature( ( FeatureExtractor::FEATURE ) feature );
+        QCOMPARE( actual.size(), expected.size() );
+        QVERIFY2( memcmp( actual.constData(), expected.constData(), expected.size() * sizeof( float ) ) == 0,
+                  qPrintable( QString( "feature %1 differs" ).arg( feature ) ) );
+    }
+}
+
+QTEST_APPLESS_MAIN( TestDetection )
+
+#include "tst_detection.moc"